@@ -65,6 +65,7 @@ option(WITH_XRENDER       "XRENDER support"            OFF)
 option(WITH_XDAMAGE       "XDAMAGE support"            OFF)
 option(WITH_XSYNC         "XSYNC support"              OFF)
 option(WITH_XCOMPOSITE    "XCOMPOSITE support"         OFF)
+option(WITH_XSHM          "XSHM support"               OFF)
 option(WITH_XKB           "XKB support"                ON)
 
 # }}}
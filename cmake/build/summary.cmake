@@ -70,5 +70,6 @@ colored_option(STATUS " XRENDER support      ${WITH_XRENDER}" WITH_XRENDER "32;1
 colored_option(STATUS " XDAMAGE support      ${WITH_XDAMAGE}" WITH_XDAMAGE "32;1" "37;2")
 colored_option(STATUS " XSYNC support        ${WITH_XSYNC}" WITH_XSYNC "32;1" "37;2")
 colored_option(STATUS " XCOMPOSITE support   ${WITH_XCOMPOSITE}" WITH_XCOMPOSITE "32;1" "37;2")
+colored_option(STATUS " XSHM support         ${WITH_XSHM}" WITH_XSHM "32;1" "37;2")
 colored_option(STATUS " XKB support          ${WITH_XKB}" WITH_XKB "32;1" "37;2")
 message(STATUS "--------------------------")
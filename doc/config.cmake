@@ -16,6 +16,18 @@ primary = #ffb52a
 secondary = #e60053
 alert = #bd2c40
 
+[settings]
+; Maximum number of times per second the bar is redrawn, 0 disables the cap.
+; Updates arriving faster than that are merged into the next frame.
+; Replaces throttle-output, throttle-output-for, eventqueue-swallow and
+; eventqueue-swallow-time, which are ignored with a deprecation warning.
+;max-fps = 60
+
+; Compile module output into draw lists once per change and hand them
+; to the renderer directly instead of parsing the whole bar contents
+; on every redraw. The --stdout output is not affected.
+;drawlist = true
+
 [global/wm]
 margin-top = 5
 margin-bottom = 5
@@ -63,6 +75,12 @@ tray-padding = 2
 
 ;override-redirect = true
 
+; Compose frames on the client and upload them with one image request
+; instead of sending fill and text requests. Uses MIT-SHM when polybar
+; is built with it and the server allows it. Text in core fonts or in
+; color fonts is still drawn by the server.
+;software-rendering = true
+
 ;scroll-up = bspwm-desknext
 ;scroll-down = bspwm-deskprev
 
@@ -288,6 +306,12 @@ battery = @BATTERY@
 adapter = @ADAPTER@
 full-at = 98
 
+; Changes are picked up from the kernel power supply events. Some batteries
+; only send them when the charging state changes, so the values are also
+; re-read every poll-interval seconds, 0 disables it. Without the kernel
+; events the battery is polled every poll-interval, at least once a second.
+;poll-interval = 5
+
 format-charging = <animation-charging> <label-charging>
 format-charging-underline = #ffb52a
 
@@ -11,9 +11,11 @@
 #endif
 
 #include "common.hpp"
+#include "components/sampler.hpp"
 #include "config.hpp"
 #include "errors.hpp"
 #include "utils/math.hpp"
+#include "utils/procfs.hpp"
 
 POLYBAR_NS
 
@@ -43,7 +45,7 @@ namespace net {
   struct link_activity {
     bytes_t transmitted{0};
     bytes_t received{0};
-    chrono::system_clock::time_point time;
+    sampler::clock::time_point time;
   };
 
   struct link_status {
@@ -57,7 +59,7 @@ namespace net {
 
   class network {
    public:
-    explicit network(string interface);
+    explicit network(string interface, sampler::duration interval);
     virtual ~network();
 
     virtual bool query(bool accumulate = false);
@@ -76,6 +78,8 @@ namespace net {
     int m_socketfd{0};
     link_status m_status{};
     string m_interface;
+    unique_ptr<procfs_file> m_operstate;
+    sampler::subscription<net_sample> m_traffic;
     bool m_tuntap{false};
   };
 
@@ -84,7 +88,7 @@ namespace net {
 
   class wired_network : public network {
    public:
-    explicit wired_network(string interface) : network(interface) {}
+    explicit wired_network(string interface, sampler::duration interval) : network(interface, interval) {}
 
     bool query(bool accumulate = false) override;
     bool connected() const override;
@@ -99,7 +103,7 @@ namespace net {
 
   class wireless_network : public network {
    public:
-    wireless_network(string interface) : network(interface) {}
+    wireless_network(string interface, sampler::duration interval) : network(interface, interval) {}
 
     bool query(bool accumulate = false) override;
     bool connected() const override;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.hpp"
+#include "errors.hpp"
+#include "utils/procfs.hpp"
+
+POLYBAR_NS
+
+namespace power_supply {
+  DEFINE_ERROR(power_supply_error);
+
+  /**
+   * Charge state of a battery and its adapter read from sysfs
+   *
+   * The files are opened once and all values are fetched in a
+   * single batch per update, so that the capacity, rate and state
+   * used in one output come from the same point in time.
+   */
+  class battery {
+   public:
+    explicit battery(string battery_path, string adapter_path);
+
+    const string& name() const;
+    const string& adapter() const;
+
+    bool update(bool with_rate = false);
+
+    bool charging() const;
+    int percentage() const;
+    unsigned long seconds() const;
+
+   private:
+    string m_name;
+    string m_adapter;
+
+    unique_ptr<procfs_file> m_online;
+    unique_ptr<procfs_file> m_status;
+    unique_ptr<procfs_file> m_capnow;
+    unique_ptr<procfs_file> m_capfull;
+    unique_ptr<procfs_file> m_rate;
+    unique_ptr<procfs_file> m_voltage;
+
+    bool m_updated{false};
+    bool m_charging{false};
+    unsigned long m_capnow_value{0UL};
+    unsigned long m_capfull_value{0UL};
+    unsigned long m_rate_value{0UL};
+    unsigned long m_voltage_value{0UL};
+  };
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common.hpp"
+#include "components/types.hpp"
+
+POLYBAR_NS
+
+/**
+ * Immutable lookup structure for the clickable areas of a frame
+ *
+ * The areas of each button are flattened into sorted, disjoint
+ * intervals that map to the first matching action block, so that
+ * hit-testing is a binary search and doesn't allocate
+ */
+class action_index {
+ public:
+  explicit action_index(vector<action_block> actions);
+
+  const action_block* find(mousebtn button, int16_t x) const;
+  const vector<action_block>& actions() const;
+
+ protected:
+  struct intervals {
+    mousebtn button;
+    /**
+     * Interval i covers the points in (bounds[i], bounds[i + 1]]
+     */
+    vector<int16_t> bounds;
+    /**
+     * Index of the action owning each interval, or -1
+     */
+    vector<int> owners;
+  };
+
+ private:
+  vector<action_block> m_actions;
+  vector<intervals> m_buttons;
+};
+
+POLYBAR_NS_END
@@ -20,6 +20,7 @@ using namespace std::chrono_literals;
 // fwd
 class config;
 class connection;
+class drawlist;
 class logger;
 class parser;
 class renderer;
@@ -44,9 +45,11 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
 
   const bar_settings settings() const;
 
-  void parse(string&& data);
+  void parse(const string& data);
+  void render(const drawlist& list);
 
  protected:
+  void begin_render();
   void restack_window();
   void reconfigure_pos();
   void reconfigure_struts();
@@ -75,6 +78,7 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
   unique_ptr<tray_manager> m_tray{};
   unique_ptr<renderer> m_renderer{};
   unique_ptr<parser> m_parser{};
+  unique_ptr<drawlist> m_drawlist{};
   unique_ptr<taskqueue> m_taskqueue;
 
   bar_settings m_opts{};
@@ -2,8 +2,10 @@
 
 #include <moodycamel/blockingconcurrentqueue.h>
 #include <thread>
+#include <unordered_map>
 
 #include "common.hpp"
+#include "components/drawlist.hpp"
 #include "events/signal_fwd.hpp"
 #include "events/signal_receiver.hpp"
 #include "events/types.hpp"
@@ -20,9 +22,11 @@ class bar;
 class command;
 class config;
 class connection;
+class eventloop;
 class inotify_watch;
 class ipc;
 class logger;
+class parser;
 class signal_emitter;
 
 namespace modules {
@@ -50,8 +54,8 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, sig_ev::exit
   using make_type = unique_ptr<controller>;
   static make_type make(unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& config_watch);
 
-  explicit controller(connection&, signal_emitter&, const logger&, const config&, unique_ptr<bar>&&, unique_ptr<ipc>&&,
-      unique_ptr<inotify_watch>&&);
+  explicit controller(connection&, signal_emitter&, const logger&, const config&, unique_ptr<eventloop>&&,
+      unique_ptr<bar>&&, unique_ptr<ipc>&&, unique_ptr<inotify_watch>&&);
   ~controller();
 
   bool run(bool writeback = false);
@@ -79,6 +83,7 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, sig_ev::exit
   signal_emitter& m_sig;
   const logger& m_log;
   const config& m_conf;
+  unique_ptr<eventloop> m_eventloop;
   unique_ptr<bar> m_bar;
   unique_ptr<ipc> m_ipc;
   unique_ptr<inotify_watch> m_confwatch;
@@ -102,20 +107,66 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, sig_ev::exit
    */
   modulemap_t m_modules;
 
+  /**
+   * @brief Cached module output with merged tags
+   */
+  std::unordered_map<const modules::module_interface*, string> m_fragments;
+
+  /**
+   * @brief Cached contents of each alignment block
+   */
+  std::map<alignment, string> m_blocks;
+
+  /**
+   * @brief Bar contents of the last frame
+   */
+  string m_contents;
+
+  /**
+   * @brief Parser used to compile the contents, unset
+   * unless draw lists are enabled
+   */
+  unique_ptr<parser> m_parser;
+
+  /**
+   * @brief Compiled module output
+   */
+  std::unordered_map<const modules::module_interface*, drawlist> m_fragmentlists;
+
+  /**
+   * @brief Compiled contents of each alignment block
+   */
+  std::map<alignment, drawlist> m_blocklists;
+
+  /**
+   * @brief Compiled bar contents of the last frame
+   */
+  drawlist m_drawlist;
+
   /**
    * @brief Module input handlers
    */
   vector<modules::input_handler*> m_inputhandlers;
 
   /**
-   * @brief Maximum number of subsequent events to swallow
+   * @brief Minimum time between two rendered frames
+   */
+  chrono::microseconds m_frame_interval{0};
+
+  /**
+   * @brief Time the last frame was rendered
+   */
+  chrono::steady_clock::time_point m_lastframe{};
+
+  /**
+   * @brief Update postponed until the frame interval has passed
    */
-  size_t m_swallow_limit{5U};
+  bool m_frame_pending{false};
 
   /**
-   * @brief Time to wait for subsequent events
+   * @brief Render the postponed update even if no module has changed
    */
-  chrono::milliseconds m_swallow_update{10ms};
+  bool m_frame_forced{false};
 
   /**
    * @brief Time to throttle input events
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "common.hpp"
+#include "components/types.hpp"
+
+POLYBAR_NS
+
+enum class drawop : uint8_t {
+  BACKGROUND = 0U,
+  FOREGROUND,
+  UNDERLINE,
+  OVERLINE,
+  FONT,
+  ALIGNMENT,
+  OFFSET,
+  ATTRIBUTE_SET,
+  ATTRIBUTE_UNSET,
+  ATTRIBUTE_TOGGLE,
+  ACTION_BEGIN,
+  ACTION_END,
+  TEXT,
+};
+
+/**
+ * Compiled form of the formatted bar contents
+ *
+ * A flat list of typed drawing operations that the renderer
+ * can execute without going through the tag syntax
+ */
+class drawlist {
+ public:
+  struct op {
+    drawop type;
+    /**
+     * Operation argument, i.e. the color, font index, alignment,
+     * offset, attribute or button. For actions and text it holds
+     * the index into the action table or text pool
+     */
+    uint32_t value;
+    /**
+     * Number of characters for text operations
+     */
+    uint32_t length;
+
+    bool operator==(const op& other) const {
+      return type == other.type && value == other.value && length == other.length;
+    }
+  };
+
+  void background(uint32_t color);
+  void foreground(uint32_t color);
+  void underline(uint32_t color);
+  void overline(uint32_t color);
+  void font(uint8_t index);
+  void align(alignment align);
+  void offset(int16_t pixels);
+  void attribute_set(attribute attr);
+  void attribute_unset(attribute attr);
+  void attribute_toggle(attribute attr);
+  void action_begin(mousebtn btn, string command);
+  void action_end(mousebtn btn);
+  void text(const uint32_t* data, size_t length);
+
+  void append(const drawlist& other);
+  void clear();
+
+  bool empty() const;
+  size_t size() const;
+
+  const vector<op>& ops() const;
+  const uint32_t* text(const op& o) const;
+  const action& get_action(const op& o) const;
+
+  bool operator==(const drawlist& other) const;
+  bool operator!=(const drawlist& other) const;
+
+ protected:
+  void push(drawop type, uint32_t value);
+
+ private:
+  vector<op> m_ops;
+  vector<uint32_t> m_text;
+  vector<action> m_actions;
+};
+
+POLYBAR_NS_END
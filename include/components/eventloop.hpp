@@ -0,0 +1,39 @@
+#pragma once
+
+#include <sys/epoll.h>
+#include <mutex>
+#include <unordered_map>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+/**
+ * Epoll based reactor that lets the controller and the modules
+ * wait for all of their file descriptors from a single thread
+ */
+class eventloop : non_copyable_mixin<eventloop> {
+ public:
+  using callback = function<void(uint32_t events)>;
+
+  using make_type = unique_ptr<eventloop>;
+  static make_type make();
+
+  explicit eventloop();
+  ~eventloop();
+
+  void attach(int fd, callback fn, uint32_t events = EPOLLIN);
+  void detach(int fd);
+  bool poll(int timeout_ms = -1);
+
+ protected:
+  static constexpr size_t MAX_EVENTS{32U};
+
+ private:
+  int m_fd{-1};
+  std::mutex m_lock;
+  std::unordered_map<int, callback> m_callbacks;
+};
+
+POLYBAR_NS_END
@@ -5,7 +5,7 @@
 
 POLYBAR_NS
 
-class signal_emitter;
+class drawlist;
 enum class attribute : uint8_t;
 enum class mousebtn : uint8_t;
 struct bar_settings;
@@ -17,31 +17,25 @@ DEFINE_CHILD_ERROR(unclosed_actionblocks, parser_error);
 
 class parser {
  public:
-  struct packet {
-    uint16_t data[128]{0U};
-    size_t length{0};
-  };
   using make_type = unique_ptr<parser>;
   static make_type make();
 
  public:
-  explicit parser(signal_emitter& emitter);
-  void parse(const bar_settings& bar, string data);
+  void compile(const bar_settings& bar, const string& data, drawlist& output);
 
  protected:
-  void codeblock(string&& data, const bar_settings& bar);
-  size_t text(string&& data);
+  void codeblock(const char* pos, const char* end, const bar_settings& bar, drawlist& output);
+  const char* text(const char* pos, const char* end, drawlist& output);
 
-  uint32_t parse_color(const string& s, uint32_t fallback = 0);
-  uint8_t parse_fontindex(const string& s);
+  uint32_t parse_color(const char* begin, const char* end, uint32_t fallback = 0);
+  uint8_t parse_fontindex(const char* begin, const char* end);
   attribute parse_attr(const char attr);
-  mousebtn parse_action_btn(const string& data);
-  string parse_action_cmd(string&& data);
+  mousebtn parse_action_btn(const char btn);
+  const char* parse_action_cmd(const char* begin, const char* end);
 
  private:
-  signal_emitter& m_sig;
   vector<int> m_actions;
-  unique_ptr<parser> m_parser;
+  vector<uint32_t> m_chars;
 };
 
 POLYBAR_NS_END
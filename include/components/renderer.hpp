@@ -1,9 +1,8 @@
 #pragma once
 
 #include "common.hpp"
+#include "components/action_index.hpp"
 #include "components/types.hpp"
-#include "events/signal_fwd.hpp"
-#include "events/signal_receiver.hpp"
 #include "x11/extensions/fwd.hpp"
 #include "x11/fonts.hpp"
 #include "x11/types.hpp"
@@ -12,25 +11,22 @@ POLYBAR_NS
 
 // fwd
 class connection;
+class drawlist;
 class font_manager;
 class logger;
-class signal_emitter;
+class surface;
 
-using namespace signals::parser;
 using std::map;
 
-class renderer
-    : public signal_receiver<SIGN_PRIORITY_RENDERER, change_background, change_foreground, change_underline,
-          change_overline, change_font, change_alignment, offset_pixel, attribute_set, attribute_unset,
-          attribute_toggle, action_begin, action_end, write_text_ascii, write_text_unicode, write_text_string> {
+class renderer {
  public:
   enum class gc : uint8_t { BG, FG, OL, UL, BT, BB, BL, BR };
 
   using make_type = unique_ptr<renderer>;
   static make_type make(const bar_settings& bar, vector<string>&& fonts);
 
-  explicit renderer(connection& conn, signal_emitter& emitter, const logger& logger,
-      unique_ptr<font_manager> font_manager, const bar_settings& bar, const vector<string>& fonts);
+  explicit renderer(connection& conn, const logger& logger, unique_ptr<font_manager> font_manager,
+      const bar_settings& bar, const vector<string>& fonts);
   ~renderer();
 
   renderer(const renderer& o) = delete;
@@ -43,6 +39,7 @@ class renderer
   void flush(bool clear);
 
   void reserve_space(edge side, uint16_t w);
+  void render(const drawlist& list);
 
   void set_background(const uint32_t color);
   void set_foreground(const uint32_t color);
@@ -54,36 +51,29 @@ class renderer
   void toggle_attribute(const attribute attr);
   bool check_attribute(const attribute attr);
 
-  void fill_background();
+  void fill_background(int16_t x, uint16_t w);
   void fill_overline(int16_t x, uint16_t w);
   void fill_underline(int16_t x, uint16_t w);
-  void fill_shift(const int16_t px);
+  void fill_offset(const int16_t px);
 
-  void draw_textstring(const uint16_t* text, size_t len);
+  void draw_textstring(const uint32_t* text, size_t len);
 
   void begin_action(const mousebtn btn, const string& cmd);
   void end_action(const mousebtn btn);
-  const vector<action_block> get_actions();
+  shared_ptr<const action_index> actions() const;
 
  protected:
-  int16_t shift_content(int16_t x, const int16_t shift_x);
-  int16_t shift_content(const int16_t shift_x);
-
-  bool on(const change_background& evt);
-  bool on(const change_foreground& evt);
-  bool on(const change_underline& evt);
-  bool on(const change_overline& evt);
-  bool on(const change_font& evt);
-  bool on(const change_alignment& evt);
-  bool on(const offset_pixel& evt);
-  bool on(const attribute_set& evt);
-  bool on(const attribute_unset& evt);
-  bool on(const attribute_toggle& evt);
-  bool on(const action_begin& evt);
-  bool on(const action_end& evt);
-  bool on(const write_text_ascii& evt);
-  bool on(const write_text_unicode& evt);
-  bool on(const write_text_string& evt);
+  void measure(const drawlist& list);
+  void draw(const drawlist& list);
+  void damage();
+  void damage(int x1, int x2);
+  bool damaged(int x1, int x2) const;
+  void paint();
+  bool paint_surface();
+
+  void record_fill(gc context, int16_t x, int16_t y, uint16_t w, uint16_t h);
+  void record_text(const shared_ptr<font_ref>& font, int16_t x, int16_t y, uint16_t w, const uint32_t* chars, size_t len);
+  void use_color(gc context, uint32_t color);
 
 #ifdef DEBUG_HINTS
   vector<xcb_window_t> m_debughints;
@@ -96,9 +86,35 @@ class renderer
     uint16_t size{0U};
   };
 
+  struct glyph {
+    shared_ptr<font_ref> font;
+    uint16_t width{0U};
+  };
+
+  /**
+   * Single fill or text draw produced while drawing the contents,
+   * kept across frames to find the areas that need to be redrawn
+   */
+  struct primitive {
+    gc context;
+    int16_t x;
+    int16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint32_t color;
+    shared_ptr<font_ref> font;
+    size_t text;
+    size_t length;
+  };
+
+  struct frame {
+    xcb_rectangle_t rect{0, 0, 0U, 0U};
+    vector<primitive> primitives;
+    vector<uint32_t> chars;
+  };
+
  private:
   connection& m_connection;
-  signal_emitter& m_sig;
   const logger& m_log;
   unique_ptr<font_manager> m_fontmanager;
 
@@ -114,15 +130,29 @@ class renderer
   xcb_visualtype_t* m_visual;
   // xcb_gcontext_t m_gcontext;
   xcb_pixmap_t m_pixmap;
+  unique_ptr<surface> m_surface;
+  bool m_surfacevalid{false};
 
   map<gc, xcb_gcontext_t> m_gcontexts;
   map<alignment, xcb_pixmap_t> m_pixmaps;
   vector<action_block> m_actions;
+  vector<size_t> m_openactions;
+  shared_ptr<const action_index> m_actionindex;
+
+  map<alignment, int16_t> m_blockx;
+  vector<glyph> m_glyphs;
+  size_t m_glyphpos{0U};
+
+  frame m_frame;
+  frame m_prevframe;
+  vector<pair<int, int>> m_damage;
+  bool m_invalidated{true};
 
   // bool m_autosize{false};
-  uint16_t m_currentx{0U};
+  int16_t m_currentx{0};
   alignment m_alignment{alignment::NONE};
   map<gc, uint32_t> m_colors;
+  map<gc, uint32_t> m_gccolors;
   uint8_t m_attributes{0U};
   uint8_t m_fontindex{0};
 
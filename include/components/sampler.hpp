@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+#include "utils/procfs.hpp"
+
+POLYBAR_NS
+
+namespace chrono = std::chrono;
+using namespace std::chrono_literals;
+
+// snapshot types {{{
+
+using sample_clock = chrono::steady_clock;
+
+enum cpu_field { CPU_USER = 0, CPU_NICE, CPU_SYSTEM, CPU_IDLE, CPU_IOWAIT, CPU_IRQ, CPU_SOFTIRQ, CPU_STEAL, CPU_FIELDS };
+
+struct cpu_sample {
+  sample_clock::time_point time;
+  size_t cores{0U};
+  /**
+   * Per core times from /proc/stat, one contiguous array per field
+   */
+  std::array<vector<uint64_t>, CPU_FIELDS> times;
+  /**
+   * Per core sum of all fields and of the idle fields (idle, iowait)
+   */
+  vector<uint64_t> total;
+  vector<uint64_t> idle;
+};
+
+/**
+ * Load of each core, in percent, between two samples
+ *
+ * Snapshots are shared by consumers polling at different intervals,
+ * so each consumer keeps the last sample it used and compares the
+ * next one against it
+ */
+struct cpu_load {
+  cpu_load() = default;
+  explicit cpu_load(const cpu_sample* previous, const cpu_sample& current);
+
+  vector<float> cores;
+  float average{0.0f};
+};
+
+struct memory_sample {
+  sample_clock::time_point time;
+  unsigned long long kb_total{0ULL};
+  unsigned long long kb_avail{0ULL};
+};
+
+struct thermal_sample {
+  sample_clock::time_point time;
+  long long millidegrees{0LL};
+};
+
+struct net_device {
+  string name;
+  unsigned long long received;
+  unsigned long long transmitted;
+};
+
+struct net_sample {
+  sample_clock::time_point time;
+  vector<net_device> devices;
+};
+
+// }}}
+
+/**
+ * Process wide reader for the system metrics used by the modules
+ *
+ * Each data source is opened once, no matter how many modules
+ * subscribe to it, and closed when the last subscription is
+ * released. A source is read at most once per fastest subscribed
+ * interval; subscribers that ask within half of that interval
+ * share the same immutable snapshot.
+ */
+class sampler : non_copyable_mixin<sampler> {
+ public:
+  using clock = sample_clock;
+  using duration = chrono::duration<double>;
+
+  template <typename Snapshot>
+  class source : non_copyable_mixin<source<Snapshot>> {
+   public:
+    using iterator = typename std::multiset<duration>::iterator;
+
+    explicit source(string path);
+
+    const string& path() const;
+
+    iterator attach(duration interval);
+    void detach(iterator it);
+
+    shared_ptr<const Snapshot> get();
+
+   private:
+    std::mutex m_lock;
+    procfs_file m_file;
+    std::multiset<duration> m_intervals;
+    shared_ptr<const Snapshot> m_snapshot;
+  };
+
+  /**
+   * Handle that keeps a source open for as long as it lives
+   */
+  template <typename Snapshot>
+  class subscription : non_copyable_mixin<subscription<Snapshot>> {
+   public:
+    subscription() = default;
+    explicit subscription(shared_ptr<source<Snapshot>> src, duration interval);
+    subscription(subscription&& other);
+    subscription& operator=(subscription&& other);
+    ~subscription();
+
+    explicit operator bool() const;
+    const string& path() const;
+
+    shared_ptr<const Snapshot> get() const;
+
+   protected:
+    void release();
+
+   private:
+    shared_ptr<source<Snapshot>> m_source;
+    typename source<Snapshot>::iterator m_interval;
+  };
+
+  using make_type = sampler&;
+  static make_type make();
+
+  subscription<cpu_sample> cpu(duration interval);
+  subscription<memory_sample> memory(duration interval);
+  subscription<thermal_sample> thermal(const string& path, duration interval);
+  subscription<net_sample> net(duration interval);
+
+ protected:
+  template <typename Snapshot>
+  subscription<Snapshot> subscribe(const string& path, duration interval);
+
+ private:
+  std::mutex m_lock;
+  std::map<string, std::weak_ptr<void>> m_sources;
+};
+
+POLYBAR_NS_END
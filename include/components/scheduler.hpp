@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+#include "utils/timer_wheel.hpp"
+
+POLYBAR_NS
+
+namespace chrono = std::chrono;
+using namespace std::chrono_literals;
+
+// fwd decl {{{
+
+class logger;
+class signal_emitter;
+
+// }}}
+
+/**
+ * Runs all periodic module updates from a small pool of workers
+ *
+ * Deadlines are aligned to multiples of the task interval so
+ * that tasks sharing an interval expire in the same tick. The
+ * expired tasks are handed to the workers, so a task blocking
+ * on IO only holds up one worker instead of all other tasks.
+ * A task never runs on two workers at the same time.
+ *
+ * A single change notification is emitted for all tasks that
+ * reported a change once the queued tasks have been run.
+ */
+class scheduler : non_copyable_mixin<scheduler> {
+ public:
+  using clock = chrono::steady_clock;
+  using duration = chrono::duration<double>;
+  using handle = timer_wheel::id_t;
+
+  /**
+   * Task callback, returns true if the module output changed
+   */
+  using callback = function<bool()>;
+
+  using make_type = scheduler&;
+  static make_type make();
+
+  explicit scheduler(signal_emitter& emitter, const logger& logger);
+  ~scheduler();
+
+  handle add(duration interval, callback fn);
+  void remove(handle task);
+  void trigger(handle task);
+
+ protected:
+  struct task {
+    timer_wheel::tick_t interval;
+    callback func;
+  };
+
+  void runner();
+  void worker();
+  void reschedule(handle id);
+  bool is_worker() const;
+  timer_wheel::tick_t current_tick() const;
+  clock::time_point tick_time(timer_wheel::tick_t tick) const;
+
+ private:
+  signal_emitter& m_sig;
+  const logger& m_log;
+
+  static constexpr chrono::milliseconds TICK{10ms};
+  static constexpr size_t WORKERS{4};
+
+  const clock::time_point m_epoch{clock::now()};
+
+  std::thread m_thread;
+  vector<std::thread> m_workers;
+  std::mutex m_lock;
+  std::condition_variable m_hold;
+  std::condition_variable m_ready;
+  std::condition_variable m_done;
+  std::atomic_bool m_active{true};
+
+  timer_wheel m_wheel;
+  std::unordered_map<handle, task> m_tasks;
+  std::deque<handle> m_queue;
+  std::unordered_set<handle> m_running;
+  std::unordered_set<handle> m_triggered;
+  handle m_counter{0};
+  bool m_changed{false};
+};
+
+POLYBAR_NS_END
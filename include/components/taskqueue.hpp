@@ -5,6 +5,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include "common.hpp"
 #include "utils/mixins.hpp"
@@ -16,20 +17,25 @@ using namespace std::chrono_literals;
 
 class taskqueue : non_copyable_mixin<taskqueue> {
  public:
-  struct deferred {
-    using clock = chrono::high_resolution_clock;
+  struct deferred : non_copyable_mixin<deferred> {
+    using clock = chrono::steady_clock;
     using duration = chrono::milliseconds;
     using timepoint = chrono::time_point<clock, duration>;
     using callback = function<void(size_t remaining)>;
 
-    explicit deferred(string id, timepoint now, duration wait, callback fn, size_t count)
-        : id(move(id)), func(move(fn)), now(move(now)), wait(move(wait)), count(move(count)) {}
+    explicit deferred(string id, timepoint deadline, duration wait, callback fn, size_t count)
+        : id(move(id)), func(move(fn)), deadline(move(deadline)), wait(move(wait)), count(move(count)) {}
 
     const string id;
     const callback func;
-    timepoint now;
+    timepoint deadline;
     duration wait;
     size_t count;
+
+    /**
+     * Position of the task in the deadline heap
+     */
+    size_t index{0};
   };
 
  public:
@@ -50,13 +56,28 @@ class taskqueue : non_copyable_mixin<taskqueue> {
  protected:
   void tick();
 
+  void push(string&& id, deferred::duration ms, deferred::callback&& fn, deferred::duration offset, size_t count);
+  bool erase(const string& id);
+  void erase(deferred* task);
+  void sift_up(size_t index);
+  void sift_down(size_t index);
+  void swap(size_t a, size_t b);
+
  private:
   std::thread m_thread;
   std::mutex m_lock{};
   std::condition_variable m_hold;
   std::atomic_bool m_active{true};
 
-  vector<unique_ptr<deferred>> m_deferred;
+  /**
+   * Min-heap of pending tasks ordered by deadline
+   */
+  vector<deferred*> m_heap;
+
+  /**
+   * Task storage indexed by id
+   */
+  std::unordered_multimap<string, unique_ptr<deferred>> m_tasks;
 };
 
 POLYBAR_NS_END
@@ -150,6 +150,7 @@ struct bar_settings {
   string locale{};
 
   bool override_redirect{false};
+  bool software_rendering{false};
 
   vector<action> actions{};
 
@@ -23,6 +23,7 @@
 #cmakedefine01 WITH_XDAMAGE
 #cmakedefine01 WITH_XSYNC
 #cmakedefine01 WITH_XCOMPOSITE
+#cmakedefine01 WITH_XSHM
 #cmakedefine01 WITH_XKB
 #cmakedefine XPP_EXTENSION_LIST @XPP_EXTENSION_LIST@
 
@@ -31,6 +32,7 @@
 #cmakedefine DEBUG_HINTS
 
 static const size_t EVENT_SIZE{64U};
+static const size_t TEXT_RUN_CACHE_SIZE{256U};
 
 static const int SIGN_PRIORITY_CONTROLLER{1};
 static const int SIGN_PRIORITY_SCREEN{2};
@@ -40,7 +40,9 @@ namespace drawtypes {
     size_t m_maxlen{0_z};
     bool m_ellipsis{true};
 
-    explicit label(string text, int font) : m_font(font), m_text(text), m_tokenized(m_text) {}
+    explicit label(string text, int font) : m_font(font), m_text(text) {
+      compile();
+    }
     explicit label(string text, string foreground = ""s, string background = ""s, string underline = ""s,
         string overline = ""s, int font = 0, struct side_values padding = {0U,0U}, struct side_values margin = {0U,0U},
         size_t maxlen = 0_z, bool ellipsis = true, vector<token>&& tokens = {})
@@ -54,24 +56,56 @@ namespace drawtypes {
         , m_maxlen(maxlen)
         , m_ellipsis(ellipsis)
         , m_text(text)
-        , m_tokenized(m_text)
-        , m_tokens(forward<vector<token>>(tokens)) {}
+        , m_tokens(forward<vector<token>>(tokens)) {
+      compile();
+    }
 
     string get() const;
     operator bool();
     label_t clone();
     void reset_tokens();
-    bool has_token(const string& token);
+    bool has_token(const string& token) const;
+    int slot(const string& token) const;
     void replace_token(const string& token, string replacement);
+    void replace_token(int slot, string replacement);
     void replace_defined_values(const label_t& label);
     void copy_undefined(const label_t& label);
 
+   protected:
+    void compile();
+
    private:
+    /**
+     * Part of the compiled text, either a literal range
+     * of m_text or a reference to a token slot
+     */
+    struct segment {
+      size_t offset;
+      size_t length;
+      int slot;
+    };
+
+    /**
+     * Value of a distinct token, using the rules of its first definition
+     *
+     * The rules are referenced by their index in m_tokens so that
+     * the slots stay valid if the label is ever copied or moved
+     */
+    struct slot_value {
+      size_t rules;
+      string value;
+    };
+
     string m_text{};
-    string m_tokenized{};
     const vector<token> m_tokens{};
+    vector<segment> m_segments{};
+    vector<slot_value> m_slots{};
+    mutable string m_tokenized{};
+    mutable bool m_dirty{true};
   };
 
+  vector<token> tokenize(string& text);
+
   label_t load_label(const config& conf, const string& section, string name, bool required = true, string def = ""s);
   label_t load_optional_label(const config& conf, string section, string name, string def = ""s);
 
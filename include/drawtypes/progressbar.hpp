@@ -28,10 +28,19 @@ namespace drawtypes {
     string output(float percentage);
 
    protected:
+    string render(unsigned int perc, unsigned int fill_width);
     void fill(unsigned int perc, unsigned int fill_width);
 
    private:
     unique_ptr<builder> m_builder;
+
+    /**
+     * Rendered output per fill width and color level,
+     * cleared whenever the settings change
+     */
+    vector<string> m_cache;
+    vector<bool> m_cached;
+
     vector<string> m_colors;
     string m_format;
     unsigned int m_width;
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <cstring>
+
 #include "common.hpp"
 
 #include "components/ipc.hpp"
-#include "components/parser.hpp"
 #include "components/types.hpp"
 #include "events/types.hpp"
 #include "utils/functional.hpp"
@@ -96,7 +97,7 @@ namespace signals {
     DEFINE_SIGNAL(2, exit_reload);
     DEFINE_SIGNAL(3, notify_change);
     DEFINE_SIGNAL(4, check_state);
-    DEFINE_SIGNAL(5, update);
+    DEFINE_VALUE_SIGNAL(5, update, bool);
   }
 
   namespace ipc {
@@ -113,26 +114,6 @@ namespace signals {
     DEFINE_SIGNAL(54, shade_window);
     DEFINE_SIGNAL(55, unshade_window);
   }
-
-  namespace parser {
-    using parser_t = polybar::parser;
-
-    DEFINE_VALUE_SIGNAL(70, change_background, uint32_t);
-    DEFINE_VALUE_SIGNAL(71, change_foreground, uint32_t);
-    DEFINE_VALUE_SIGNAL(72, change_underline, uint32_t);
-    DEFINE_VALUE_SIGNAL(73, change_overline, uint32_t);
-    DEFINE_VALUE_SIGNAL(74, change_font, uint8_t);
-    DEFINE_VALUE_SIGNAL(75, change_alignment, alignment);
-    DEFINE_VALUE_SIGNAL(76, offset_pixel, int16_t);
-    DEFINE_VALUE_SIGNAL(77, attribute_set, attribute);
-    DEFINE_VALUE_SIGNAL(78, attribute_unset, attribute);
-    DEFINE_VALUE_SIGNAL(79, attribute_toggle, attribute);
-    DEFINE_VALUE_SIGNAL(80, action_begin, action);
-    DEFINE_VALUE_SIGNAL(81, action_end, mousebtn);
-    DEFINE_VALUE_SIGNAL(82, write_text_ascii, uint16_t);
-    DEFINE_VALUE_SIGNAL(83, write_text_unicode, uint16_t);
-    DEFINE_VALUE_SIGNAL(84, write_text_string, parser_t::packet);
-  }
 }
 
 POLYBAR_NS_END
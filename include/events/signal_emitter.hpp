@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "common.hpp"
 #include "events/signal_receiver.hpp"
 #include "utils/factory.hpp"
@@ -26,13 +28,14 @@ class signal_emitter {
 
   template <typename Signal>
   bool emit(const Signal& sig) {
-    try {
-      for (auto&& item : g_signal_receivers.at(id<Signal>())) {
-        if (item.second->on(sig)) {
-          return true;
-        }
+    const auto& slots = g_signal_receivers[id<Signal>()];
+
+    // Indexed loop since receivers may detach while handling the signal
+    for (size_t i = 0; i < slots.size(); i++) {
+      const auto slot = slots[i];
+      if (slot.callback(slot.receiver, &sig)) {
+        return true;
       }
-    } catch (...) {
     }
 
     return false;
@@ -59,19 +62,32 @@ class signal_emitter {
     return Signal::id();
   }
 
+  template <typename Receiver, typename Signal>
+  static bool invoke(signal_receiver_interface* s, const void* sig) {
+    signal_receiver_impl<Signal>* impl{static_cast<Receiver*>(s)};
+    return impl->on(*static_cast<const Signal*>(sig));
+  }
+
   template <typename Receiver, typename Signal>
   void attach(Receiver* s) {
-    attach(s, id<Signal>());
+    attach(s, id<Signal>(), &invoke<Receiver, Signal>);
   }
 
   template <typename Receiver, typename Signal, typename Next, typename... Signals>
   void attach(Receiver* s) {
-    attach(s, id<Signal>());
+    attach(s, id<Signal>(), &invoke<Receiver, Signal>);
     attach<Receiver, Next, Signals...>(s);
   }
 
-  void attach(signal_receiver_interface* s, uint8_t id) {
-    g_signal_receivers[id].emplace(s->priority(), s);
+  /**
+   * Insert slot after any slots with the same priority
+   */
+  void attach(signal_receiver_interface* s, uint8_t id, signal_slot::callback_t callback) {
+    auto& slots = g_signal_receivers[id];
+    auto priority = s->priority();
+    auto pos = std::upper_bound(slots.begin(), slots.end(), priority,
+        [](signal_receiver_interface::prio p, const signal_slot& slot) { return p < slot.priority; });
+    slots.insert(pos, signal_slot{priority, s, callback});
   }
 
   template <typename Receiver, typename Signal>
@@ -86,19 +102,9 @@ class signal_emitter {
   }
 
   void detach(signal_receiver_interface* d, uint8_t id) {
-    try {
-      auto& prio_map = g_signal_receivers.at(id);
-      const auto& prio_sink_pair = prio_map.equal_range(d->priority());
-
-      for (auto it = prio_sink_pair.first; it != prio_sink_pair.second;) {
-        if (d == it->second) {
-          it = prio_map.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    } catch (...) {
-    }
+    auto& slots = g_signal_receivers[id];
+    slots.erase(std::remove_if(slots.begin(), slots.end(), [d](const signal_slot& slot) { return slot.receiver == d; }),
+        slots.end());
   }
 };
 
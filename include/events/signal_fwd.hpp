@@ -28,23 +28,6 @@ namespace signals {
     struct shade_window;
     struct unshade_window;
   }
-  namespace parser {
-    struct change_background;
-    struct change_foreground;
-    struct change_underline;
-    struct change_overline;
-    struct change_font;
-    struct change_alignment;
-    struct offset_pixel;
-    struct attribute_set;
-    struct attribute_unset;
-    struct attribute_toggle;
-    struct action_begin;
-    struct action_end;
-    struct write_text_ascii;
-    struct write_text_unicode;
-    struct write_text_string;
-  }
 }
 
 POLYBAR_NS_END
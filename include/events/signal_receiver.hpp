@@ -1,7 +1,6 @@
 #pragma once
 
-#include <map>
-#include <unordered_map>
+#include <array>
 
 #include "common.hpp"
 
@@ -10,11 +9,8 @@ POLYBAR_NS
 class signal_receiver_interface {
  public:
   using prio = unsigned int;
-  using prio_map = std::multimap<prio, signal_receiver_interface*>;
   virtual ~signal_receiver_interface() {}
   virtual prio priority() const = 0;
-  template <typename Signal>
-  bool on(const Signal& signal);
 };
 
 template <typename Signal>
@@ -24,17 +20,6 @@ class signal_receiver_impl {
   virtual bool on(const Signal&) = 0;
 };
 
-template <typename Signal>
-bool signal_receiver_interface::on(const Signal& s) {
-  auto event_sink = dynamic_cast<signal_receiver_impl<Signal>*>(this);
-
-  if (event_sink != nullptr && event_sink->on(s)) {
-    return true;
-  } else {
-    return false;
-  }
-}
-
 template <uint8_t Priority, typename Signal, typename... Signals>
 class signal_receiver : public signal_receiver_interface,
                         public signal_receiver_impl<Signal>,
@@ -45,6 +30,23 @@ class signal_receiver : public signal_receiver_interface,
   }
 };
 
-using signal_receivers_t = std::unordered_map<uint8_t, signal_receiver_interface::prio_map>;
+/**
+ * Dispatch entry created when a receiver is attached
+ *
+ * The callback is instantiated for the concrete receiver and
+ * signal type, so emitting only needs an indirect call
+ */
+struct signal_slot {
+  using callback_t = bool (*)(signal_receiver_interface*, const void*);
+
+  signal_receiver_interface::prio priority;
+  signal_receiver_interface* receiver;
+  callback_t callback;
+};
+
+/**
+ * Slots indexed by signal id, each list sorted by priority
+ */
+using signal_receivers_t = std::array<vector<signal_slot>, 256>;
 
 POLYBAR_NS_END
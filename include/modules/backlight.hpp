@@ -3,6 +3,7 @@
 #include "components/config.hpp"
 #include "config.hpp"
 #include "modules/meta/inotify_module.hpp"
+#include "utils/procfs.hpp"
 
 POLYBAR_NS
 
@@ -14,7 +15,7 @@ namespace modules {
       float read() const;
 
      private:
-      string m_path;
+      unique_ptr<procfs_file> m_file;
     };
 
    public:
@@ -22,7 +23,7 @@ namespace modules {
 
     void idle();
     bool on_event(inotify_event* event);
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto TAG_LABEL = "<label>";
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <atomic>
+
+#include "adapters/power_supply.hpp"
 #include "common.hpp"
-#include "modules/meta/inotify_module.hpp"
+#include "components/scheduler.hpp"
+#include "modules/meta/event_module.hpp"
+#include "utils/uevent.hpp"
 
 POLYBAR_NS
 
 namespace modules {
-  class battery_module : public inotify_module<battery_module> {
+  class battery_module : public event_module<battery_module> {
    public:
     enum class state {
       NONE = 0,
@@ -15,49 +20,21 @@ namespace modules {
       FULL,
     };
 
-    enum class value {
-      NONE = 0,
-      ADAPTER,
-      CAPACITY,
-      CAPACITY_MAX,
-      VOLTAGE,
-      RATE,
-    };
-
-    template <typename ReturnType>
-    struct value_reader {
-      using return_type = ReturnType;
-
-      explicit value_reader() = default;
-      explicit value_reader(function<ReturnType()>&& fn) : m_fn(forward<decltype(fn)>(fn)) {}
-
-      ReturnType read() const {
-        return m_fn();
-      }
-
-     private:
-      const function<ReturnType()> m_fn;
-    };
-
-    using state_reader = mutex_wrapper<value_reader<bool /* is_charging */>>;
-    using capacity_reader = mutex_wrapper<value_reader<int /* percentage */>>;
-    using rate_reader = mutex_wrapper<value_reader<unsigned long /* seconds */>>;
-
-   public:
     explicit battery_module(const bar_settings&, string);
 
     void start();
     void teardown();
     void idle();
-    bool on_event(inotify_event* event);
+    int get_file_descriptor() const;
+    bool has_event();
+    bool update();
     string get_format() const;
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
-    state current_state();
-    int current_percentage(state state);
-    string current_time();
-    void subthread();
+    bool poll();
+    string current_time() const;
+    void animate(bool enable);
 
    private:
     static constexpr const char* FORMAT_CHARGING{"format-charging"};
@@ -71,11 +48,8 @@ namespace modules {
     static constexpr const char* TAG_LABEL_DISCHARGING{"<label-discharging>"};
     static constexpr const char* TAG_LABEL_FULL{"<label-full>"};
 
-    static const size_t SKIP_N_UNCHANGED{3_z};
-
-    unique_ptr<state_reader> m_state_reader;
-    unique_ptr<capacity_reader> m_capacity_reader;
-    unique_ptr<rate_reader> m_rate_reader;
+    unique_ptr<power_supply::battery> m_battery;
+    unique_ptr<uevent_socket> m_uevents;
 
     label_t m_label_charging;
     label_t m_label_discharging;
@@ -84,21 +58,16 @@ namespace modules {
     progressbar_t m_bar_capacity;
     ramp_t m_ramp_capacity;
 
-    string m_fstate;
-    string m_fcapnow;
-    string m_fcapfull;
-    string m_frate;
-    string m_fvoltage;
-
-    state m_state{state::DISCHARGING};
+    std::atomic<state> m_state{state::DISCHARGING};
     int m_percentage{0};
 
     int m_fullat{100};
     string m_timeformat;
-    size_t m_unchanged{SKIP_N_UNCHANGED};
     chrono::duration<double> m_interval{};
-    chrono::system_clock::time_point m_lastpoll;
-    thread m_subthread;
+
+    scheduler& m_scheduler{scheduler::make()};
+    scheduler::handle m_animation{0};
+    scheduler::handle m_poll{0};
   };
 }
 
@@ -42,10 +42,11 @@ namespace modules {
     explicit bspwm_module(const bar_settings&, string);
 
     void stop();
+    int get_file_descriptor() const;
     bool has_event();
     bool update();
     string get_output();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     bool input(string&& cmd);
@@ -10,7 +10,7 @@ namespace modules {
     explicit counter_module(const bar_settings&, string);
 
     bool update();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto TAG_COUNTER = "<counter>";
@@ -1,31 +1,18 @@
 #pragma once
 
+#include "components/sampler.hpp"
 #include "config.hpp"
 #include "modules/meta/timer_module.hpp"
 
 POLYBAR_NS
 
 namespace modules {
-  struct cpu_time {
-    unsigned long long user;
-    unsigned long long nice;
-    unsigned long long system;
-    unsigned long long idle;
-    unsigned long long total;
-  };
-
-  using cpu_time_t = unique_ptr<cpu_time>;
-
   class cpu_module : public timer_module<cpu_module> {
    public:
     explicit cpu_module(const bar_settings&, string);
 
     bool update();
-    bool build(builder* builder, const string& tag) const;
-
-   protected:
-    bool read_values();
-    float get_load(size_t core) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto TAG_LABEL = "<label>";
@@ -38,11 +25,13 @@ namespace modules {
     ramp_t m_rampload_core;
     label_t m_label;
 
-    vector<cpu_time_t> m_cputimes;
-    vector<cpu_time_t> m_cputimes_prev;
+    int m_slot_percentage{-1};
+    int m_slot_cores{-1};
+    vector<int> m_slot_core;
 
-    float m_total = 0;
-    vector<float> m_load;
+    sampler::subscription<cpu_sample> m_stat;
+    shared_ptr<const cpu_sample> m_sample;
+    cpu_load m_load;
   };
 }
 
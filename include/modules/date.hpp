@@ -11,7 +11,7 @@ namespace modules {
     explicit date_module(const bar_settings&, string);
 
     bool update();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     bool input(string&& cmd);
@@ -42,7 +42,7 @@ namespace modules {
     bool update();
     string get_format() const;
     string get_output();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto FORMAT_MOUNTED = "format-mounted";
@@ -37,9 +37,10 @@ namespace modules {
     explicit i3_module(const bar_settings&, string);
 
     void stop();
+    int get_file_descriptor() const;
     bool has_event();
     bool update();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     bool input(string&& cmd);
@@ -30,7 +30,7 @@ namespace modules {
 
     void update() {}
     string get_output();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
     void on_message(const string& message);
 
    private:
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "components/sampler.hpp"
 #include "config.hpp"
 #include "modules/meta/timer_module.hpp"
 
@@ -13,14 +14,18 @@ namespace modules {
     explicit memory_module(const bar_settings&, string);
 
     bool update();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto TAG_LABEL = "<label>";
     static constexpr auto TAG_BAR_USED = "<bar-used>";
     static constexpr auto TAG_BAR_FREE = "<bar-free>";
 
+    enum label_slot { GB_USED = 0, GB_FREE, GB_TOTAL, MB_USED, MB_FREE, MB_TOTAL, PERCENTAGE_USED, PERCENTAGE_FREE, SLOTS };
+
+    sampler::subscription<memory_sample> m_meminfo;
     label_t m_label;
+    int m_slots[SLOTS];
     progressbar_t m_bar_free;
     map<memtype, progressbar_t> m_bars;
     map<memtype, int> m_perc;
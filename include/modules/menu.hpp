@@ -20,7 +20,7 @@ namespace modules {
    public:
     explicit menu_module(const bar_settings&, string);
 
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
     void update() {}
 
    protected:
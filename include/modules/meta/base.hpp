@@ -59,8 +59,29 @@ namespace modules {
 
   // class definition : module_format {{{
 
+  /**
+   * Format tag identifier, the FNV-1a hash of the tag name
+   *
+   * Computed at compile time for the TAG_* constants so that
+   * build() can dispatch using a switch statement
+   */
+  using tag_t = uint32_t;
+
+  constexpr tag_t tag_id(const char* tag, tag_t hash = 2166136261U) {
+    return *tag ? tag_id(tag + 1, (hash ^ static_cast<uint8_t>(*tag)) * 16777619U) : hash;
+  }
+
+  enum class format_op : uint8_t { TAG, SPACE, TEXT };
+
+  struct format_node {
+    format_op op;
+    tag_t tag;
+    string text;
+  };
+
   struct module_format {
     string value{};
+    vector<format_node> nodes{};
     vector<string> tags{};
     label_t prefix{};
     label_t suffix{};
@@ -73,6 +94,7 @@ namespace modules {
     int margin{};
     int offset{};
 
+    void compile();
     string decorate(builder* builder, string output);
   };
 
@@ -108,6 +130,7 @@ namespace modules {
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual void halt(string error_message) = 0;
+    virtual bool changed() const = 0;
     virtual string contents() = 0;
   };
 
@@ -125,10 +148,12 @@ namespace modules {
     void stop();
     void halt(string error_message);
     void teardown();
+    bool changed() const;
     string contents();
 
    protected:
     void broadcast();
+    void invalidate();
     void idle();
     void sleep(chrono::duration<double> sleep_duration);
     void wakeup();
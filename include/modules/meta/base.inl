@@ -75,6 +75,11 @@ namespace modules {
   template <typename Impl>
   void module<Impl>::teardown() {}
 
+  template <typename Impl>
+  bool module<Impl>::changed() const {
+    return m_changed;
+  }
+
   template <typename Impl>
   string module<Impl>::contents() {
     if (m_changed) {
@@ -90,10 +95,15 @@ namespace modules {
 
   template <typename Impl>
   void module<Impl>::broadcast() {
-    m_changed = true;
+    invalidate();
     m_sig.emit(sig_ev::notify_change{});
   }
 
+  template <typename Impl>
+  void module<Impl>::invalidate() {
+    m_changed = true;
+  }
+
   template <typename Impl>
   void module<Impl>::idle() {
     CAST_MOD(Impl)->sleep(25ms);
@@ -126,20 +136,23 @@ namespace modules {
     int i = 0;
     bool tag_built = true;
 
-    for (auto&& tag : string_util::split(format->value, ' ')) {
-      bool is_blankspace = tag.empty();
-
-      if (tag[0] == '<' && tag[tag.length() - 1] == '>') {
-        if (i > 0)
-          m_builder->space(format->spacing);
-        if (!(tag_built = CONST_MOD(Impl).build(m_builder.get(), tag)) && i > 0)
-          m_builder->remove_trailing_space(format->spacing);
-        if (tag_built)
-          i++;
-      } else if (is_blankspace && tag_built) {
-        m_builder->space(1_z);
-      } else if (!is_blankspace) {
-        m_builder->node(tag);
+    for (auto&& node : format->nodes) {
+      switch (node.op) {
+        case format_op::TAG:
+          if (i > 0)
+            m_builder->space(format->spacing);
+          if (!(tag_built = CONST_MOD(Impl).build(m_builder.get(), node.tag)) && i > 0)
+            m_builder->remove_trailing_space(format->spacing);
+          if (tag_built)
+            i++;
+          break;
+        case format_op::SPACE:
+          if (tag_built)
+            m_builder->space(1_z);
+          break;
+        case format_op::TEXT:
+          m_builder->node(node.text);
+          break;
       }
     }
 
@@ -7,12 +7,15 @@
 POLYBAR_NS
 
 class connection;
+class eventloop;
 
 namespace modules {
   struct event_handler_interface {
     virtual ~event_handler_interface() {}
     virtual void connect(connection&) {}
     virtual void disconnect(connection&) {}
+    virtual void attach(eventloop&) {}
+    virtual void detach(eventloop&) {}
   };
 
   template <typename Event, typename... Events>
@@ -1,20 +1,110 @@
 #pragma once
 
+#include "components/eventloop.hpp"
 #include "modules/meta/base.hpp"
+#include "modules/meta/event_handler.hpp"
 
 POLYBAR_NS
 
 namespace modules {
   template <class Impl>
-  class event_module : public module<Impl> {
+  class event_module : public module<Impl>, public event_handler_interface {
    public:
     using module<Impl>::module;
 
     void start() {
-      this->m_mainthread = thread(&event_module::runner, this);
+      if (m_eventloop == nullptr || CAST_MOD(Impl)->get_file_descriptor() == -1) {
+        this->m_mainthread = thread(&event_module::runner, this);
+        return;
+      }
+
+      try {
+        // Warm up the module output before handing the
+        // event source over to the event loop
+        CAST_MOD(Impl)->update();
+        CAST_MOD(Impl)->broadcast();
+
+        std::lock_guard<std::mutex> guard(this->m_updatelock);
+        watch(CAST_MOD(Impl)->get_file_descriptor());
+      } catch (const exception& err) {
+        CAST_MOD(Impl)->halt(err.what());
+      }
+    }
+
+    void stop() {
+      {
+        std::lock_guard<std::mutex> guard(this->m_updatelock);
+        unwatch();
+      }
+      module<Impl>::stop();
+    }
+
+    void attach(eventloop& loop) override {
+      m_eventloop = &loop;
+    }
+
+    void detach(eventloop&) override {
+      std::lock_guard<std::mutex> guard(this->m_updatelock);
+      unwatch();
+      m_eventloop = nullptr;
+    }
+
+    /**
+     * File descriptor that signals pending events
+     *
+     * Modules that return -1 are serviced by their own thread
+     */
+    int get_file_descriptor() const {
+      return -1;
     }
 
    protected:
+    void watch(int fd) {
+      m_eventloop->attach(fd, [this](uint32_t events) { process_events(events); });
+      m_fd = fd;
+    }
+
+    void unwatch() {
+      if (m_eventloop != nullptr && m_fd != -1) {
+        m_eventloop->detach(m_fd);
+      }
+      m_fd = -1;
+    }
+
+    /**
+     * Service the event source from the event loop thread
+     *
+     * The descriptor is only changed while holding the update lock,
+     * so that a concurrent stop() can't be undone by re-attaching it
+     * or by starting the fallback runner
+     */
+    void process_events(uint32_t events) {
+      try {
+        std::lock_guard<std::mutex> guard(this->m_updatelock);
+
+        if (this->running() && CAST_MOD(Impl)->has_event() && this->running() && CAST_MOD(Impl)->update()) {
+          CAST_MOD(Impl)->broadcast();
+        }
+
+        int fd{CAST_MOD(Impl)->get_file_descriptor()};
+
+        if (!this->running() || m_fd == -1) {
+          return;
+        } else if (fd != m_fd && fd != -1) {
+          // The module has replaced its event source, e.g. after reconnecting
+          unwatch();
+          watch(fd);
+        } else if (fd == -1 || (events & (EPOLLHUP | EPOLLERR))) {
+          // The descriptor is gone or would keep signalling,
+          // so leave it to the blocking runner from now on
+          unwatch();
+          this->m_mainthread = thread(&event_module::runner, this);
+        }
+      } catch (const exception& err) {
+        CAST_MOD(Impl)->halt(err.what());
+      }
+    }
+
     void runner() {
       try {
         // Warm up the module output before entering the loop
@@ -44,6 +134,10 @@ namespace modules {
         CAST_MOD(Impl)->halt(err.what());
       }
     }
+
+   private:
+    eventloop* m_eventloop{nullptr};
+    int m_fd{-1};
   };
 }
 
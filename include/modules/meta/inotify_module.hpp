@@ -15,6 +15,14 @@ namespace modules {
       this->m_mainthread = thread(&inotify_module::runner, this);
     }
 
+    /**
+     * Interrupt a pending poll, e.g. when the module is stopped
+     */
+    void wakeup() {
+      m_inotify.interrupt();
+      module<Impl>::wakeup();
+    }
+
    protected:
     void runner() {
       try {
@@ -23,7 +31,6 @@ namespace modules {
         CAST_MOD(Impl)->broadcast();
 
         while (this->running()) {
-          std::lock_guard<std::mutex> guard(this->m_updatelock);
           CAST_MOD(Impl)->poll_events();
         }
       } catch (const module_error& err) {
@@ -36,54 +43,71 @@ namespace modules {
     void watch(string path, int mask = IN_ALL_EVENTS) {
       this->m_log.trace("%s: Attach inotify at %s", this->name(), path);
       m_watchlist.insert(make_pair(path, mask));
+      m_attached = false;
     }
 
     void idle() {
       this->sleep(200ms);
     }
 
+    /**
+     * Wait for events on the watched paths
+     *
+     * The watches are attached once and stay attached, all events
+     * queued since the last poll are merged into a single update
+     */
     void poll_events() {
-      vector<unique_ptr<inotify_watch>> watches;
-
-      try {
-        for (auto&& w : m_watchlist) {
-          watches.emplace_back(inotify_util::make_watch(w.first));
-          watches.back()->attach(w.second);
+      if (!m_attached) {
+        try {
+          for (auto&& w : m_watchlist) {
+            m_inotify.attach(w.first, w.second);
+          }
+          m_attached = true;
+        } catch (const system_error& e) {
+          this->m_log.err("%s: Error while creating inotify watch (what: %s)", this->name(), e.what());
+          CAST_MOD(Impl)->sleep(0.1s);
+          return;
         }
-      } catch (const system_error& e) {
-        watches.clear();
-        this->m_log.err("%s: Error while creating inotify watch (what: %s)", this->name(), e.what());
-        CAST_MOD(Impl)->sleep(0.1s);
-        return;
       }
 
-      while (this->running()) {
-        for (auto&& w : watches) {
-          this->m_log.trace_x("%s: Poll inotify watch %s", this->name(), w->path());
+      inotify_event event{};
+
+      if (m_inotify.poll(1000)) {
+        m_inotify.read([&](const inotify_event& e) {
+          this->m_log.trace_x("%s: Inotify event for %s", this->name(), e.filename);
+          event.filename = e.filename;
+          event.is_dir = e.is_dir;
+          event.wd = e.wd;
+          event.cookie = e.cookie;
+          event.mask |= e.mask;
+        });
+      }
 
-          if (w->poll(1000 / watches.size())) {
-            auto event = w->get_event();
+      std::lock_guard<std::mutex> guard(this->m_updatelock);
 
-            for (auto&& w : watches) {
-              w->remove(true);
-            }
+      if (!this->running()) {
+        return;
+      }
 
-            if (CAST_MOD(Impl)->on_event(event.get())) {
-              CAST_MOD(Impl)->broadcast();
-            }
-            CAST_MOD(Impl)->idle();
-            return;
-          }
+      if (event.mask & IN_IGNORED) {
+        m_attached = false;
+      }
 
-          if (!this->running())
-            break;
+      if (event.mask) {
+        if (CAST_MOD(Impl)->on_event(&event)) {
+          CAST_MOD(Impl)->broadcast();
         }
-        CAST_MOD(Impl)->idle();
+        // Drop the events caused by the module reading the watched files
+        m_inotify.read(nullptr);
       }
+
+      CAST_MOD(Impl)->idle();
     }
 
    private:
     map<string, int> m_watchlist;
+    inotify_watcher m_inotify;
+    bool m_attached{false};
   };
 }
 
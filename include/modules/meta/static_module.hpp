@@ -15,7 +15,7 @@ namespace modules {
       CAST_MOD(Impl)->broadcast();
     }
 
-    bool build(builder*, string) const {
+    bool build(builder*, tag_t) const {
       return true;
     }
   };
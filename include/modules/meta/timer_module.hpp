@@ -1,5 +1,6 @@
 #pragma once
 
+#include "components/scheduler.hpp"
 #include "modules/meta/base.hpp"
 
 POLYBAR_NS
@@ -7,37 +8,52 @@ POLYBAR_NS
 namespace modules {
   using interval_t = chrono::duration<double>;
 
+  /**
+   * Module updated at a fixed interval by the shared scheduler
+   */
   template <class Impl>
   class timer_module : public module<Impl> {
    public:
     using module<Impl>::module;
 
     void start() {
-      this->m_mainthread = thread(&timer_module::runner, this);
+      m_task = m_scheduler.add(m_interval, [this] { return runner(); });
+    }
+
+    void stop() {
+      m_scheduler.remove(m_task);
+      module<Impl>::stop();
+    }
+
+    /**
+     * Force an update on the next scheduler tick
+     */
+    void wakeup() {
+      m_scheduler.trigger(m_task);
+      module<Impl>::wakeup();
     }
 
    protected:
-    void runner() {
+    bool runner() {
       try {
-        while (this->running()) {
-          std::unique_lock<std::mutex> guard(this->m_updatelock);
-
-          if (CAST_MOD(Impl)->update()) {
-            this->broadcast();
-          }
+        std::lock_guard<std::mutex> guard(this->m_updatelock);
 
-          if (this->running()) {
-            guard.unlock();
-            this->sleep(m_interval);
-          }
+        if (this->running() && CAST_MOD(Impl)->update()) {
+          this->invalidate();
+          return true;
         }
       } catch (const exception& err) {
         this->halt(err.what());
       }
+      return false;
     }
 
    protected:
     interval_t m_interval{1.0};
+
+   private:
+    scheduler& m_scheduler{scheduler::make()};
+    scheduler::handle m_task{0};
   };
 }
 
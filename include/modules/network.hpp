@@ -16,7 +16,7 @@ namespace modules {
     void teardown();
     bool update();
     string get_format() const;
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     void subthread_routine();
@@ -15,7 +15,7 @@ namespace modules {
     explicit reddit_module(const bar_settings&, string);
 
     bool update();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto TAG_LABEL = "<label>";
@@ -23,7 +23,7 @@ namespace modules {
     bool has_event();
     bool update();
     string get_output();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     static constexpr const char* TAG_OUTPUT{"<output>"};
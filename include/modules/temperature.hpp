@@ -1,7 +1,6 @@
 #pragma once
 
-#include <istream>
-
+#include "components/sampler.hpp"
 #include "config.hpp"
 #include "modules/meta/timer_module.hpp"
 
@@ -16,7 +15,7 @@ namespace modules {
 
     bool update();
     string get_format() const;
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    private:
     static constexpr auto TAG_LABEL = "<label>";
@@ -28,6 +27,7 @@ namespace modules {
     ramp_t m_ramp;
 
     string m_path;
+    sampler::subscription<thermal_sample> m_zonefile;
     int m_zone = 0;
     int m_tempwarn = 0;
     int m_temp = 0;
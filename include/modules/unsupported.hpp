@@ -26,6 +26,9 @@ namespace modules {
     void start() {}                                                                     \
     void stop() {}                                                                      \
     void halt(string) {}                                                                \
+    bool changed() const {                                                              \
+      return false;                                                                     \
+    }                                                                                   \
     string contents() {                                                                 \
       return "";                                                                        \
     }                                                                                   \
@@ -27,7 +27,7 @@ namespace modules {
 
     string get_output();
     void update();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     bool query_keyboard();
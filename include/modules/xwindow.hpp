@@ -34,7 +34,7 @@ namespace modules {
     explicit xwindow_module(const bar_settings&, string);
 
     void update(bool force = false);
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     void handle(const evt::property_notify& evt);
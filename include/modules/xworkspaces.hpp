@@ -57,7 +57,7 @@ namespace modules {
 
     void update();
     string get_output();
-    bool build(builder* builder, const string& tag) const;
+    bool build(builder* builder, tag_t tag) const;
 
    protected:
     void handle(const evt::property_notify& evt);
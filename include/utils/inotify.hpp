@@ -3,9 +3,11 @@
 #include <poll.h>
 #include <sys/inotify.h>
 #include <cstdio>
+#include <map>
 
 #include "common.hpp"
 #include "utils/factory.hpp"
+#include "utils/mixins.hpp"
 
 POLYBAR_NS
 
@@ -37,6 +39,33 @@ class inotify_watch {
   int m_mask{0};
 };
 
+/**
+ * Single inotify instance holding any number of watches
+ *
+ * Queued events are read in bulk and resolved to the watched
+ * path through their watch descriptor. A blocking poll can be
+ * interrupted from another thread.
+ */
+class inotify_watcher : non_copyable_mixin<inotify_watcher> {
+ public:
+  using callback = function<void(const inotify_event&)>;
+
+  explicit inotify_watcher();
+  ~inotify_watcher();
+
+  int attach(const string& path, int mask = IN_MODIFY);
+  bool poll(int wait_ms = -1);
+  void interrupt();
+  size_t read(const callback& fn);
+  int get_file_descriptor() const;
+
+ protected:
+  int m_fd{-1};
+  int m_wakeupfd{-1};
+  std::map<int, string> m_watches;
+  vector<char> m_buffer;
+};
+
 namespace inotify_util {
   template <typename... Args>
   decltype(auto) make_watch(Args&&... args) {
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+/**
+ * Allocation free parser for the contents of /proc and /sys files
+ */
+class procfs_scanner {
+ public:
+  explicit procfs_scanner(const char* data, size_t size);
+
+  bool eof() const;
+  bool match(const char* prefix) const;
+  bool seek(const char* key);
+  void skip_word();
+  void next_line();
+  bool next(long long& value);
+  bool next(string& word, char delimiter);
+
+ private:
+  const char* m_pos;
+  const char* m_end;
+};
+
+/**
+ * Handle to a /proc or /sys file that stays open between reads
+ *
+ * Each read fetches the current contents with pread() at offset 0
+ * into a buffer that is reused for the lifetime of the handle.
+ * The file is reopened on the next read if it fails to open or
+ * a read fails, e.g. when a power supply is removed.
+ */
+class procfs_file : non_copyable_mixin<procfs_file> {
+ public:
+  explicit procfs_file(string path);
+  ~procfs_file();
+
+  const string& path() const;
+
+  bool read();
+  bool read(long long& value);
+  bool read(float& value);
+
+  const char* data() const;
+  size_t size() const;
+  procfs_scanner scan() const;
+
+ protected:
+  bool open();
+  void close();
+
+ private:
+  string m_path;
+  int m_fd{-1};
+  vector<char> m_buffer;
+  size_t m_size{0U};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <unordered_map>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+/**
+ * Hierarchical timer wheel
+ *
+ * Timers are identified by caller provided ids and expire at
+ * absolute ticks. Each level has 64 slots and covers 64 times
+ * the range of the level below it. Timers are moved down to
+ * the next level once their slot comes up (cascading), so
+ * insert, remove and expire are all constant time.
+ */
+class timer_wheel {
+ public:
+  using tick_t = uint64_t;
+  using id_t = size_t;
+
+  static constexpr size_t LEVELS{4U};
+  static constexpr size_t SLOT_BITS{6U};
+  static constexpr size_t SLOTS{1U << SLOT_BITS};
+
+  explicit timer_wheel(tick_t now = 0);
+
+  void insert(id_t id, tick_t expires);
+  bool remove(id_t id);
+  bool contains(id_t id) const;
+
+  void advance(tick_t to, vector<id_t>& expired);
+
+  tick_t now() const;
+  tick_t next_expiry() const;
+  size_t size() const;
+  bool empty() const;
+
+ protected:
+  struct entry {
+    tick_t expires;
+    size_t level;
+    size_t slot;
+    std::list<id_t>::iterator pos;
+  };
+
+  void place(id_t id, entry& e, tick_t at);
+  void unlink(entry& e);
+  void cascade(size_t level, size_t slot);
+  void expire(size_t slot, vector<id_t>& expired);
+
+ private:
+  tick_t m_now{0};
+  std::unordered_map<id_t, entry> m_entries;
+  array<array<std::list<id_t>, SLOTS>, LEVELS> m_slots;
+  array<uint64_t, LEVELS> m_occupied{};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <map>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+/**
+ * Kernel object event broadcast over netlink
+ */
+struct uevent {
+  string action;
+  string devpath;
+  string subsystem;
+  std::map<string, string> properties;
+
+  string name() const;
+};
+
+namespace uevent_util {
+  bool parse(const char* data, size_t size, uevent& event);
+}
+
+/**
+ * Listener for the kernel uevents of a single subsystem
+ *
+ * The socket is non-blocking, all queued messages are drained
+ * on each read so it can be serviced by the shared event loop
+ */
+class uevent_socket : non_copyable_mixin<uevent_socket> {
+ public:
+  using callback = function<void(const uevent&)>;
+
+  explicit uevent_socket(string subsystem);
+  explicit uevent_socket(string subsystem, int fd);
+  ~uevent_socket();
+
+  int get_file_descriptor() const;
+  bool poll(int wait_ms = -1) const;
+  size_t read(const callback& fn);
+
+ private:
+  string m_subsystem;
+  int m_fd{-1};
+  vector<char> m_buffer;
+};
+
+POLYBAR_NS_END
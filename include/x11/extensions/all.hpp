@@ -17,6 +17,9 @@
 #if WITH_XCOMPOSITE
 #include "x11/extensions/composite.hpp"
 #endif
+#if WITH_XSHM
+#include "x11/extensions/shm.hpp"
+#endif
 #if WITH_XKB
 #include "x11/extensions/xkb.hpp"
 #endif
@@ -28,6 +28,11 @@ namespace xpp {
     class extension;
   }
 #endif
+#if WITH_XSHM
+  namespace shm {
+    class extension;
+  }
+#endif
 #if WITH_XKB
   namespace xkb {
     class extension;
@@ -8,3 +8,29 @@
 
 #include <xcb/render.h>
 #include <xpp/proto/render.hpp>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+// fwd
+class connection;
+
+namespace render_util {
+  /**
+   * Header of a glyph list item used by the CompositeGlyphs requests
+   */
+  struct glyph_elt {
+    uint8_t len;
+    uint8_t pad[3];
+    int16_t deltax;
+    int16_t deltay;
+  };
+
+  void query_extension(connection& conn);
+
+  xcb_render_pictformat_t find_alpha_format(connection& conn);
+  xcb_render_pictformat_t find_visual_format(connection& conn, xcb_visualid_t visual);
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "config.hpp"
+
+#if not WITH_XSHM
+#error "X Shm extension is disabled..."
+#endif
+
+#include <xcb/shm.h>
+#include <xpp/proto/shm.hpp>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+// fwd
+class connection;
+
+namespace shm_util {
+  void query_extension(connection& conn);
+  bool has_extension(connection& conn);
+}
+
+POLYBAR_NS_END
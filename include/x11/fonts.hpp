@@ -4,10 +4,16 @@
 #include FT_FREETYPE_H
 #include FT_OUTLINE_H
 #include FT_GLYPH_H
+#include FT_SYNTHESIS_H
 
 #include <X11/Xft/Xft.h>
 #include <xcb/xcbext.h>
+#include <array>
 #include <unordered_map>
+#if WITH_XRENDER
+#include <xcb/render.h>
+#include <unordered_set>
+#endif
 
 #include "common.hpp"
 #include "x11/color.hpp"
@@ -22,6 +28,27 @@ using std::unordered_map;
 class connection;
 class logger;
 
+/**
+ * Measured run of characters drawn with a single font
+ */
+struct text_run {
+  vector<FT_UInt> glyphs{};
+  vector<uint16_t> advances{};
+  uint32_t width{0U};
+};
+
+/**
+ * Coverage mask of a rasterized glyph
+ */
+struct glyph_bitmap {
+  uint16_t width{0U};
+  uint16_t rows{0U};
+  int16_t left{0};
+  int16_t top{0};
+  int16_t advance{0};
+  vector<uint8_t> coverage{};
+};
+
 struct font_ref {
   explicit font_ref() = default;
   font_ref(const font_ref& o) = delete;
@@ -36,7 +63,15 @@ struct font_ref {
   uint16_t char_max{0};
   uint16_t char_min{0};
   vector<xcb_charinfo_t> width_lut{};
-  unordered_map<uint16_t, wchar_t> glyph_widths{};
+  unordered_map<FT_UInt, uint16_t> glyph_advances{};
+  unordered_map<std::u32string, text_run> runs{};
+  unordered_map<std::u32string, text_run> prevruns{};
+  unordered_map<FT_UInt, unique_ptr<glyph_bitmap>> bitmaps{};
+#if WITH_XRENDER
+  xcb_render_glyphset_t glyphset{XCB_NONE};
+  std::unordered_set<FT_UInt> glyphset_loaded{};
+  bool glyphset_usable{true};
+#endif
 
   static struct _deleter { void operator()(font_ref* font); } deleter;
 };
@@ -57,22 +92,38 @@ class font_manager {
   void cleanup();
   bool load(const string& name, uint8_t fontindex = 0, int8_t offset_y = 0);
   void fontindex(uint8_t index);
-  shared_ptr<font_ref> match_char(const uint16_t chr);
-  uint8_t glyph_width(const shared_ptr<font_ref>& font, const uint16_t chr);
+  shared_ptr<font_ref> match_char(const uint32_t chr);
+  const text_run& measure(const shared_ptr<font_ref>& font, const uint32_t* chars, size_t len);
+  const glyph_bitmap* rasterize(const shared_ptr<font_ref>& font, FT_UInt glyph);
   void drawtext(const shared_ptr<font_ref>& font, xcb_pixmap_t pm, xcb_gcontext_t gc, int16_t x, int16_t y,
-      const uint16_t* chars, size_t num_chars);
+      const uint32_t* chars, size_t num_chars);
 
   void allocate_color(uint32_t color);
   void allocate_color(XRenderColor color);
 
  protected:
+  /**
+   * Page of 256 codepoints pointing at the matching font,
+   * unresolved entries are null
+   */
+  using char_page = std::array<const shared_ptr<font_ref>*, 256>;
+  using char_table = vector<unique_ptr<char_page>>;
+
+  const shared_ptr<font_ref>& find_char(const uint32_t chr);
   bool open_xcb_font(const shared_ptr<font_ref>& font, string fontname);
 
-  uint8_t glyph_width_xft(const shared_ptr<font_ref>& font, const uint16_t chr);
-  uint8_t glyph_width_xcb(const shared_ptr<font_ref>& font, const uint16_t chr);
+  void measure_xft(const shared_ptr<font_ref>& font, const uint32_t* chars, text_run& run);
+  void measure_xcb(const shared_ptr<font_ref>& font, const uint32_t* chars, text_run& run);
+  uint16_t glyph_width_xcb(const shared_ptr<font_ref>& font, const uint32_t chr);
 
-  bool has_glyph_xft(const shared_ptr<font_ref>& font, const uint16_t chr);
-  bool has_glyph_xcb(const shared_ptr<font_ref>& font, const uint16_t chr);
+  bool has_glyph_xft(const shared_ptr<font_ref>& font, const uint32_t chr);
+  bool has_glyph_xcb(const shared_ptr<font_ref>& font, const uint32_t chr);
+
+#if WITH_XRENDER
+  bool render_glyphs(
+      const shared_ptr<font_ref>& font, xcb_pixmap_t pm, int16_t x, int16_t y, const vector<FT_UInt>& glyphs);
+  bool upload_glyphs(const shared_ptr<font_ref>& font, const vector<FT_UInt>& glyphs);
+#endif
 
   void xcb_poly_text_16(xcb_drawable_t d, xcb_gcontext_t gc, int16_t x, int16_t y, uint8_t len, uint16_t* str);
 
@@ -87,9 +138,20 @@ class font_manager {
   map<uint8_t, shared_ptr<font_ref>> m_fonts{};
   uint8_t m_fontindex{0};
 
+  map<uint8_t, char_table> m_chartables{};
+  const shared_ptr<font_ref> m_nomatch{};
+
   XftDraw* m_xftdraw{nullptr};
   XftColor m_xftcolor{};
   bool m_xftcolor_allocated{false};
+
+#if WITH_XRENDER
+  xcb_render_pictformat_t m_alphaformat{XCB_NONE};
+  xcb_render_pictformat_t m_targetformat{XCB_NONE};
+  xcb_render_picture_t m_target{XCB_NONE};
+  xcb_pixmap_t m_targetpixmap{XCB_NONE};
+  xcb_render_picture_t m_fill{XCB_NONE};
+#endif
 };
 
 POLYBAR_NS_END
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <xcb/xcb.h>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+// fwd
+class connection;
+
+/**
+ * Client side ARGB32 image that the bar contents are composed
+ * into before being uploaded to a drawable in a single request
+ *
+ * Uses a shared memory segment when the MIT-SHM extension is
+ * available and falls back to regular PutImage requests
+ */
+class surface {
+ public:
+  explicit surface(connection& conn, uint8_t depth, uint16_t w, uint16_t h);
+  ~surface();
+
+  surface(const surface& o) = delete;
+  surface& operator=(const surface& o) = delete;
+
+  uint16_t width() const;
+  uint16_t height() const;
+  void resize(uint16_t w, uint16_t h);
+
+  void fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint32_t color);
+  void blend(int16_t x, int16_t y, const uint8_t* mask, uint16_t w, uint16_t h, uint32_t color);
+  void upload(xcb_drawable_t dst, xcb_gcontext_t gc, int16_t x, uint16_t w);
+
+ protected:
+  void allocate();
+  void release();
+  void sync();
+
+ private:
+  connection& m_connection;
+  uint8_t m_depth;
+  uint16_t m_width;
+  uint16_t m_height;
+
+  uint32_t* m_data{nullptr};
+  vector<uint32_t> m_buffer;
+  bool m_pending{false};
+
+#if WITH_XSHM
+  uint32_t m_segment{XCB_NONE};
+  bool m_shared{true};
+#endif
+};
+
+POLYBAR_NS_END
@@ -9,7 +9,6 @@
 #include <utility>
 
 #include <linux/ethtool.h>
-#include <linux/if_link.h>
 #include <linux/sockios.h>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -42,13 +41,16 @@ namespace net {
   /**
    * Construct network interface
    */
-  network::network(string interface) : m_interface(move(interface)) {
+  network::network(string interface, sampler::duration interval) : m_interface(move(interface)) {
     if (if_nametoindex(m_interface.c_str()) == 0) {
       throw network_error("Invalid network interface \"" + m_interface + "\"");
     }
     if ((m_socketfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
       throw network_error("Failed to open socket");
     }
+
+    m_operstate = make_unique<procfs_file>("/sys/class/net/" + m_interface + "/operstate");
+    m_traffic = sampler::make().net(interval);
     check_tuntap();
   }
 
@@ -66,46 +68,32 @@ namespace net {
    */
   bool network::query(bool accumulate) {
     struct ifaddrs* ifaddr;
+    auto traffic = m_traffic.get();
 
-    if (getifaddrs(&ifaddr) == -1 || ifaddr == nullptr) {
+    if (!traffic || getifaddrs(&ifaddr) == -1 || ifaddr == nullptr) {
       return false;
     }
 
     m_status.previous = m_status.current;
     m_status.current.transmitted = 0;
     m_status.current.received = 0;
-    m_status.current.time = chrono::system_clock::now();
+    m_status.current.time = traffic->time;
 
-    for (auto ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
-      if (ifa->ifa_addr == nullptr) {
-        continue;
+    for (auto&& device : traffic->devices) {
+      if (accumulate || device.name == m_interface) {
+        m_status.current.transmitted += device.transmitted;
+        m_status.current.received += device.received;
       }
+    }
 
-      if (m_interface.compare(0, m_interface.length(), ifa->ifa_name) != 0) {
-        if (!accumulate || (ifa->ifa_data == nullptr && ifa->ifa_addr->sa_family != AF_PACKET)) {
-          continue;
-        }
+    for (auto ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
+      if (ifa->ifa_addr == nullptr || ifa->ifa_addr->sa_family != AF_INET || m_interface != ifa->ifa_name) {
+        continue;
       }
 
-      switch (ifa->ifa_addr->sa_family) {
-        case AF_INET:
-          char ip_buffer[NI_MAXHOST];
-          getnameinfo(ifa->ifa_addr, sizeof(sockaddr_in), ip_buffer, NI_MAXHOST, nullptr, 0, NI_NUMERICHOST);
-          m_status.ip = string{ip_buffer};
-          break;
-
-        case AF_PACKET:
-          if (ifa->ifa_data == nullptr) {
-            continue;
-          }
-          struct rtnl_link_stats* link_state = reinterpret_cast<decltype(link_state)>(ifa->ifa_data);
-          if (link_state == nullptr) {
-            continue;
-          }
-          m_status.current.transmitted += link_state->tx_bytes;
-          m_status.current.received += link_state->rx_bytes;
-          break;
-      }
+      char ip_buffer[NI_MAXHOST];
+      getnameinfo(ifa->ifa_addr, sizeof(sockaddr_in), ip_buffer, NI_MAXHOST, nullptr, 0, NI_NUMERICHOST);
+      m_status.ip = string{ip_buffer};
     }
 
     freeifaddrs(ifaddr);
@@ -182,7 +170,7 @@ namespace net {
    * Test if the network interface is in a valid state
    */
   bool network::test_interface() const {
-    return file_util::contents("/sys/class/net/" + m_interface + "/operstate").compare(0, 2, "up") == 0;
+    return m_operstate->read() && m_operstate->scan().match("up");
   }
 
   /**
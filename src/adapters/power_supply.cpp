@@ -0,0 +1,138 @@
+#include "adapters/power_supply.hpp"
+#include "utils/file.hpp"
+#include "utils/math.hpp"
+
+POLYBAR_NS
+
+namespace power_supply {
+  /**
+   * Read an unsigned sysfs value, 0 if it can't be read
+   */
+  static unsigned long read_value(procfs_file& file) {
+    long long value{0};
+    return file.read(value) && value > 0 ? static_cast<unsigned long>(value) : 0UL;
+  }
+
+  /**
+   * Locate the sysfs files of the battery and adapter
+   */
+  battery::battery(string battery_path, string adapter_path) {
+    m_name = battery_path.substr(battery_path.rfind('/') + 1);
+    m_adapter = adapter_path.substr(adapter_path.rfind('/') + 1);
+
+    battery_path += "/";
+    adapter_path += "/";
+
+    if (file_util::exists(adapter_path + "online")) {
+      m_online = make_unique<procfs_file>(adapter_path + "online");
+    } else if (file_util::exists(battery_path + "status")) {
+      m_status = make_unique<procfs_file>(battery_path + "status");
+    } else {
+      throw power_supply_error("No suitable way to get current charge state");
+    }
+
+    string path;
+
+    if ((path = file_util::pick({battery_path + "charge_now", battery_path + "energy_now"})).empty()) {
+      throw power_supply_error("No suitable way to get current capacity value");
+    }
+    m_capnow = make_unique<procfs_file>(path);
+
+    if ((path = file_util::pick({battery_path + "charge_full", battery_path + "energy_full"})).empty()) {
+      throw power_supply_error("No suitable way to get max capacity value");
+    }
+    m_capfull = make_unique<procfs_file>(path);
+
+    if ((path = file_util::pick({battery_path + "voltage_now"})).empty()) {
+      throw power_supply_error("No suitable way to get current voltage value");
+    }
+    m_voltage = make_unique<procfs_file>(path);
+
+    if ((path = file_util::pick({battery_path + "current_now", battery_path + "power_now"})).empty()) {
+      throw power_supply_error("No suitable way to get current charge rate value");
+    }
+    m_rate = make_unique<procfs_file>(path);
+  }
+
+  /**
+   * Kernel name of the battery, e.g. BAT0
+   */
+  const string& battery::name() const {
+    return m_name;
+  }
+
+  /**
+   * Kernel name of the adapter, e.g. ADP1
+   */
+  const string& battery::adapter() const {
+    return m_adapter;
+  }
+
+  /**
+   * Fetch the current values, the rate and voltage
+   * are only needed for the time estimate
+   *
+   * Returns true if any of the fetched values changed
+   */
+  bool battery::update(bool with_rate) {
+    bool charging{false};
+
+    if (m_online) {
+      charging = m_online->read() && m_online->scan().match("1");
+    } else {
+      charging = m_status->read() && m_status->scan().match("Charging");
+    }
+
+    auto capnow = read_value(*m_capnow);
+    auto capfull = read_value(*m_capfull);
+    auto rate = with_rate ? read_value(*m_rate) : m_rate_value;
+    auto voltage = with_rate ? read_value(*m_voltage) : m_voltage_value;
+
+    bool changed{!m_updated || charging != m_charging || capnow != m_capnow_value || capfull != m_capfull_value ||
+                 rate != m_rate_value || voltage != m_voltage_value};
+
+    m_updated = true;
+
+    m_charging = charging;
+    m_capnow_value = capnow;
+    m_capfull_value = capfull;
+    m_rate_value = rate;
+    m_voltage_value = voltage;
+
+    return changed;
+  }
+
+  /**
+   * Test if the adapter is online or the battery reports charging
+   */
+  bool battery::charging() const {
+    return m_charging;
+  }
+
+  /**
+   * Get the capacity level
+   */
+  int battery::percentage() const {
+    return math_util::percentage(m_capnow_value, 0UL, m_capfull_value);
+  }
+
+  /**
+   * Get the estimated number of seconds until fully dis-/charged,
+   * or 0 if the rate is unknown
+   */
+  unsigned long battery::seconds() const {
+    unsigned long rate{m_rate_value / 1000UL};
+    unsigned long volt{m_voltage_value / 1000UL};
+    unsigned long now{m_capnow_value / 1000UL};
+    unsigned long max{m_capfull_value / 1000UL};
+    unsigned long cap{m_charging ? max - now : now};
+
+    if (rate && volt && cap) {
+      return 3600UL * (cap * 1000UL / volt) / (rate * 1000UL / volt);
+    } else {
+      return 0UL;
+    }
+  }
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,86 @@
+#include <algorithm>
+
+#include "components/action_index.hpp"
+
+POLYBAR_NS
+
+/**
+ * Build the intervals for all completed action blocks
+ *
+ * When areas for the same button overlap, the block that was
+ * opened first wins, matching the order they were created in
+ */
+action_index::action_index(vector<action_block> actions) : m_actions(move(actions)) {
+  for (size_t i = 0; i < m_actions.size(); i++) {
+    const auto& action = m_actions[i];
+
+    if (action.active) {
+      continue;
+    }
+
+    auto it = std::find_if(m_buttons.begin(), m_buttons.end(),
+        [&](const intervals& btn) { return btn.button == action.button; });
+
+    if (it == m_buttons.end()) {
+      m_buttons.emplace_back(intervals{action.button, {}, {}});
+      it = m_buttons.end() - 1;
+    }
+
+    it->bounds.emplace_back(static_cast<int16_t>(action.start_x));
+    it->bounds.emplace_back(static_cast<int16_t>(action.end_x));
+  }
+
+  for (auto&& btn : m_buttons) {
+    std::sort(btn.bounds.begin(), btn.bounds.end());
+    btn.bounds.erase(std::unique(btn.bounds.begin(), btn.bounds.end()), btn.bounds.end());
+    btn.owners.assign(btn.bounds.size() - 1, -1);
+  }
+
+  for (size_t i = 0; i < m_actions.size(); i++) {
+    const auto& action = m_actions[i];
+
+    if (action.active) {
+      continue;
+    }
+
+    auto& btn = *std::find_if(m_buttons.begin(), m_buttons.end(),
+        [&](const intervals& b) { return b.button == action.button; });
+
+    auto first = std::lower_bound(btn.bounds.begin(), btn.bounds.end(), static_cast<int16_t>(action.start_x));
+    auto last = std::lower_bound(first, btn.bounds.end(), static_cast<int16_t>(action.end_x));
+
+    for (auto n = first - btn.bounds.begin(); n < last - btn.bounds.begin(); n++) {
+      if (btn.owners[n] == -1) {
+        btn.owners[n] = static_cast<int>(i);
+      }
+    }
+  }
+}
+
+/**
+ * Find the action block for given button at the given position
+ */
+const action_block* action_index::find(mousebtn button, int16_t x) const {
+  for (auto&& btn : m_buttons) {
+    if (btn.button != button) {
+      continue;
+    }
+
+    auto it = std::lower_bound(btn.bounds.begin(), btn.bounds.end(), x);
+
+    if (it == btn.bounds.begin() || it == btn.bounds.end()) {
+      return nullptr;
+    }
+
+    auto owner = btn.owners[it - btn.bounds.begin() - 1];
+    return owner == -1 ? nullptr : &m_actions[owner];
+  }
+
+  return nullptr;
+}
+
+const vector<action_block>& action_index::actions() const {
+  return m_actions;
+}
+
+POLYBAR_NS_END
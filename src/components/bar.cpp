@@ -3,6 +3,7 @@
 
 #include "components/bar.hpp"
 #include "components/config.hpp"
+#include "components/drawlist.hpp"
 #include "components/parser.hpp"
 #include "components/renderer.hpp"
 #include "components/screen.hpp"
@@ -64,6 +65,7 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
     , m_screen(forward<decltype(screen)>(screen))
     , m_tray(forward<decltype(tray_manager)>(tray_manager))
     , m_parser(forward<decltype(parser)>(parser))
+    , m_drawlist(make_unique<drawlist>())
     , m_taskqueue(forward<decltype(taskqueue)>(taskqueue)) {
   string bs{m_conf.section()};
 
@@ -141,6 +143,7 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
   m_opts.module_margin.right = m_conf.get(bs, "module-margin-right", m_opts.module_margin.right);
   m_opts.separator = string_util::trim(m_conf.get(bs, "separator", ""s), '"');
   m_opts.locale = m_conf.get(bs, "locale", ""s);
+  m_opts.software_rendering = m_conf.get(bs, "software-rendering", m_opts.software_rendering);
 
   if (only_initialize_values) {
     return;
@@ -279,7 +282,6 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
 
   m_log.trace("bar: Drawing empty bar");
   m_renderer->begin();
-  m_renderer->fill_background();
   m_renderer->end();
 
   m_log.trace("bar: Setup tray manager");
@@ -312,7 +314,7 @@ const bar_settings bar::settings() const {
  * @param data Input string
  * @param force Unless true, do not parse unchanged data
  */
-void bar::parse(string&& data) {
+void bar::parse(const string& data) {
   if (!m_mutex.try_lock()) {
     return;
   }
@@ -329,6 +331,44 @@ void bar::parse(string&& data) {
 
   m_lastinput = data;
 
+  m_drawlist->clear();
+
+  try {
+    m_parser->compile(settings(), data, *m_drawlist);
+  } catch (const parser_error& err) {
+    m_log.err("Failed to parse contents (reason: %s)", err.what());
+  }
+
+  begin_render();
+  m_renderer->render(*m_drawlist);
+  m_renderer->end();
+}
+
+/**
+ * Redraw the bar window using compiled contents
+ */
+void bar::render(const drawlist& list) {
+  if (!m_mutex.try_lock()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(m_mutex, std::adopt_lock);
+
+  if (m_opts.shaded) {
+    return m_log.trace("bar: Ignoring update (shaded)");
+  }
+
+  m_lastinput.clear();
+
+  begin_render();
+  m_renderer->render(list);
+  m_renderer->end();
+}
+
+/**
+ * Prepare the renderer for a new frame
+ */
+void bar::begin_render() {
   m_log.info("Redrawing bar window");
   m_renderer->begin();
 
@@ -339,16 +379,6 @@ void bar::parse(string&& data) {
       m_renderer->reserve_space(edge::RIGHT, m_tray->settings().configured_w);
     }
   }
-
-  m_renderer->fill_background();
-
-  try {
-    m_parser->parse(settings(), data);
-  } catch (const parser_error& err) {
-    m_log.err("Failed to parse contents (reason: %s)", err.what());
-  }
-
-  m_renderer->end();
 }
 
 /**
@@ -540,12 +570,12 @@ void bar::handle(const evt::button_press& evt) {
   m_buttonpress_pos = evt->event_x;
 
   const auto deferred_fn = [&](size_t) {
-    for (auto&& action : m_renderer->get_actions()) {
-      if (action.button == m_buttonpress_btn && !action.active && action.test(m_buttonpress_pos)) {
-        m_log.trace("Found matching input area");
-        m_sig.emit(button_press{string{action.command}});
-        return;
-      }
+    auto actions = m_renderer->actions();
+    auto action = actions ? actions->find(m_buttonpress_btn, m_buttonpress_pos) : nullptr;
+    if (action != nullptr) {
+      m_log.trace("Found matching input area");
+      m_sig.emit(button_press{string{action->command}});
+      return;
     }
     for (auto&& action : m_opts.actions) {
       if (action.button == m_buttonpress_btn && !action.command.empty()) {
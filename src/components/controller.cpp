@@ -3,8 +3,11 @@
 #include "components/bar.hpp"
 #include "components/config.hpp"
 #include "components/controller.hpp"
+#include "components/drawlist.hpp"
+#include "components/eventloop.hpp"
 #include "components/ipc.hpp"
 #include "components/logger.hpp"
+#include "components/parser.hpp"
 #include "components/renderer.hpp"
 #include "components/types.hpp"
 #include "events/signal.hpp"
@@ -25,6 +28,43 @@
 
 POLYBAR_NS
 
+namespace {
+  /**
+   * Strip reset tags that are directly followed by a new value
+   * for the same tag and join consecutive tags, in a single pass
+   *
+   * E.g. "%{F-}%{F#fff}%{B#000}" becomes "%{F#fff B#000}"
+   */
+  string merge_tags(string&& contents) {
+    string merged;
+    merged.reserve(contents.size());
+
+    size_t pos{0};
+    size_t next{0};
+
+    while ((next = contents.find("}%{", pos)) != string::npos) {
+      if (next >= 2 && contents[next - 1] == '-' && next + 3 < contents.size() &&
+          contents[next - 2] == contents[next + 3]) {
+        char tag{contents[next - 2]};
+        bool has_color{next + 4 < contents.size() && contents[next + 4] == '#'};
+
+        if (tag == 'T' || (has_color && (tag == 'B' || tag == 'F' || tag == 'U' || tag == 'u' || tag == 'o'))) {
+          merged.append(contents, pos, next - 2 - pos);
+          pos = next + 3;
+          continue;
+        }
+      }
+
+      merged.append(contents, pos, next - pos);
+      merged += ' ';
+      pos = next + 3;
+    }
+
+    merged.append(contents, pos, string::npos);
+    return merged;
+  }
+}
+
 array<int, 2> g_eventpipe{{-1, -1}};
 sig_atomic_t g_reload{0};
 sig_atomic_t g_terminate{0};
@@ -42,24 +82,42 @@ void interrupt_handler(int signum) {
  */
 controller::make_type controller::make(unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& config_watch) {
   return factory_util::unique<controller>(connection::make(), signal_emitter::make(), logger::make(), config::make(),
-      bar::make(), forward<decltype(ipc)>(ipc), forward<decltype(config_watch)>(config_watch));
+      eventloop::make(), bar::make(), forward<decltype(ipc)>(ipc), forward<decltype(config_watch)>(config_watch));
 }
 
 /**
  * Construct controller
  */
 controller::controller(connection& conn, signal_emitter& emitter, const logger& logger, const config& config,
-    unique_ptr<bar>&& bar, unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& confwatch)
+    unique_ptr<eventloop>&& loop, unique_ptr<bar>&& bar, unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& confwatch)
     : m_connection(conn)
     , m_sig(emitter)
     , m_log(logger)
     , m_conf(config)
+    , m_eventloop(forward<decltype(loop)>(loop))
     , m_bar(forward<decltype(bar)>(bar))
     , m_ipc(forward<decltype(ipc)>(ipc))
     , m_confwatch(forward<decltype(confwatch)>(confwatch)) {
   m_swallow_input = m_conf.get("settings", "throttle-input-for", m_swallow_input);
-  m_swallow_limit = m_conf.deprecated("settings", "eventqueue-swallow", "throttle-output", m_swallow_limit);
-  m_swallow_update = m_conf.deprecated("settings", "eventqueue-swallow-time", "throttle-output-for", m_swallow_update);
+
+  // The output is no longer throttled by swallowing events
+  // but capped by the number of frames rendered per second
+  m_conf.warn_deprecated("settings", "eventqueue-swallow", "max-fps");
+  m_conf.warn_deprecated("settings", "eventqueue-swallow-time", "max-fps");
+  m_conf.warn_deprecated("settings", "throttle-output", "max-fps");
+  m_conf.warn_deprecated("settings", "throttle-output-for", "max-fps");
+
+  auto max_fps = m_conf.get("settings", "max-fps", 60_z);
+  if (max_fps) {
+    m_frame_interval = chrono::duration_cast<decltype(m_frame_interval)>(1s) / max_fps;
+  }
+
+  // Compile module output into draw lists that are handed
+  // to the renderer directly instead of re-parsing the
+  // formatted contents on every frame
+  if (m_conf.get("settings", "drawlist", false)) {
+    m_parser = parser::make();
+  }
 
   if (pipe(g_eventpipe.data()) == 0) {
     m_queuefd[PIPE_READ] = make_unique<file_descriptor>(g_eventpipe[PIPE_READ]);
@@ -167,6 +225,7 @@ bool controller::run(bool writeback) {
 
       if (evt_handler != nullptr) {
         evt_handler->connect(m_connection);
+        evt_handler->attach(*m_eventloop);
       }
 
       try {
@@ -230,86 +289,91 @@ bool controller::enqueue(string&& input_data) {
 
 /**
  * Read events from configured file descriptors
+ *
+ * All descriptors, including the ones registered by modules,
+ * are serviced by the event loop on the calling thread
  */
 void controller::read_events() {
   m_log.info("Entering event loop (thread-id=%lu)", this_thread::get_id());
 
-  int fd_connection{-1};
+  int fd_queue{*m_queuefd[PIPE_READ]};
+  int fd_connection{m_connection.get_file_descriptor()};
   int fd_confwatch{-1};
-  int fd_ipc{-1};
 
-  vector<int> fds;
-  fds.emplace_back(*m_queuefd[PIPE_READ]);
-  fds.emplace_back((fd_connection = m_connection.get_file_descriptor()));
+  // Process event on the internal fd
+  m_eventloop->attach(fd_queue, [&](uint32_t) {
+    char buffer[BUFSIZ]{'\0'};
+    if (read(fd_queue, &buffer, BUFSIZ) == -1) {
+      m_log.err("Failed to read from eventpipe (err: %s)", strerror(errno));
+    }
+  });
 
+  // Process event on the xcb connection fd
+  m_eventloop->attach(fd_connection, [&](uint32_t) {
+    shared_ptr<xcb_generic_event_t> evt{};
+    while ((evt = shared_ptr<xcb_generic_event_t>(xcb_poll_for_event(m_connection), free)) != nullptr) {
+      try {
+        m_connection.dispatch_event(evt);
+      } catch (xpp::connection_error& err) {
+        m_log.err("X connection error, terminating... (what: %s)", m_connection.error_str(err.code()));
+      } catch (const exception& err) {
+        m_log.err("Error in X event loop: %s", err.what());
+      }
+    }
+  });
+
+  // Process event on the config inotify watch fd
   if (m_confwatch) {
     m_log.trace("controller: Attach config watch");
     m_confwatch->attach(IN_MODIFY);
-    fds.emplace_back((fd_confwatch = m_confwatch->get_file_descriptor()));
+    m_eventloop->attach((fd_confwatch = m_confwatch->get_file_descriptor()), [&](uint32_t) {
+      if (m_confwatch->await_match()) {
+        m_log.info("Configuration file changed");
+        g_terminate = 1;
+        g_reload = 1;
+      }
+    });
   }
 
+  // Process event on the ipc fd
+  // The channel is reopened after each message so the
+  // new descriptor has to be registered again
+  eventloop::callback ipc_handler;
+  ipc_handler = [&](uint32_t) {
+    m_eventloop->detach(m_ipc->get_file_descriptor());
+    m_ipc->receive_message();
+    m_eventloop->attach(m_ipc->get_file_descriptor(), ipc_handler);
+  };
+
   if (m_ipc) {
-    fds.emplace_back((fd_ipc = m_ipc->get_file_descriptor()));
+    m_eventloop->attach(m_ipc->get_file_descriptor(), ipc_handler);
   }
 
   while (!g_terminate) {
-    fd_set readfds{};
-    FD_ZERO(&readfds);
-
-    int maxfd{0};
-    for (auto&& fd : fds) {
-      FD_SET(fd, &readfds);
-      maxfd = std::max(maxfd, fd);
-    }
-
     // Wait until event is ready on one of the configured streams
-    int events = select(maxfd + 1, &readfds, nullptr, nullptr, nullptr);
-
-    // Check for errors
-    if (events == -1 || g_terminate || m_connection.connection_has_error()) {
+    if (!m_eventloop->poll() || g_terminate || m_connection.connection_has_error()) {
       break;
     }
+  }
 
-    // Process event on the internal fd
-    if (m_queuefd[PIPE_READ] && FD_ISSET(static_cast<int>(*m_queuefd[PIPE_READ]), &readfds)) {
-      char buffer[BUFSIZ]{'\0'};
-      if (read(static_cast<int>(*m_queuefd[PIPE_READ]), &buffer, BUFSIZ) == -1) {
-        m_log.err("Failed to read from eventpipe (err: %s)", strerror(errno));
-      }
-    }
-
-    // Process event on the config inotify watch fd
-    if (fd_confwatch > -1 && FD_ISSET(fd_confwatch, &readfds) && m_confwatch->await_match()) {
-      m_log.info("Configuration file changed");
-      g_terminate = 1;
-      g_reload = 1;
-    }
-
-    // Process event on the xcb connection fd
-    if (fd_connection > -1 && FD_ISSET(fd_connection, &readfds)) {
-      shared_ptr<xcb_generic_event_t> evt{};
-      while ((evt = shared_ptr<xcb_generic_event_t>(xcb_poll_for_event(m_connection), free)) != nullptr) {
-        try {
-          m_connection.dispatch_event(evt);
-        } catch (xpp::connection_error& err) {
-          m_log.err("X connection error, terminating... (what: %s)", m_connection.error_str(err.code()));
-        } catch (const exception& err) {
-          m_log.err("Error in X event loop: %s", err.what());
-        }
-      }
-    }
+  m_eventloop->detach(fd_queue);
+  m_eventloop->detach(fd_connection);
 
-    // Process event on the ipc fd
-    if (fd_ipc > -1 && FD_ISSET(fd_ipc, &readfds)) {
-      m_ipc->receive_message();
-      fds.erase(std::remove_if(fds.begin(), fds.end(), [fd_ipc](int fd) { return fd == fd_ipc; }), fds.end());
-      fds.emplace_back((fd_ipc = m_ipc->get_file_descriptor()));
-    }
+  if (fd_confwatch > -1) {
+    m_eventloop->detach(fd_confwatch);
+  }
+  if (m_ipc) {
+    m_eventloop->detach(m_ipc->get_file_descriptor());
   }
 }
 
 /**
  * Eventqueue worker loop
+ *
+ * Updates are rendered right away unless the previous frame is more
+ * recent than the frame interval. In that case the update is postponed
+ * until the interval has passed and merged with any update that
+ * arrives in the meantime.
  */
 void controller::process_eventqueue() {
   m_log.info("Eventqueue worker (thread-id=%lu)", this_thread::get_id());
@@ -318,7 +382,16 @@ void controller::process_eventqueue() {
 
   while (!g_terminate) {
     event evt{};
-    m_queue.wait_dequeue(evt);
+
+    if (!m_frame_pending) {
+      m_queue.wait_dequeue(evt);
+    } else {
+      auto remaining = chrono::duration_cast<chrono::microseconds>(
+          m_lastframe + m_frame_interval - chrono::steady_clock::now());
+      if (!m_queue.wait_dequeue_timed(evt, std::max(remaining, chrono::microseconds{0}))) {
+        evt = make_update_evt(false);
+      }
+    }
 
     if (g_terminate) {
       break;
@@ -330,40 +403,23 @@ void controller::process_eventqueue() {
       }
     } else if (evt.type == event_type::INPUT) {
       process_inputdata();
-    } else {
-      event next{};
-      size_t swallowed{0};
-      while (swallowed++ < m_swallow_limit && m_queue.wait_dequeue_timed(next, m_swallow_update)) {
-        if (next.type == event_type::QUIT) {
-          evt = next;
-          break;
-        } else if (next.type == event_type::INPUT) {
-          evt = next;
-          break;
-        } else if (evt.type != next.type) {
-          enqueue(move(next));
-          break;
-        } else {
-          m_log.trace_x("controller: Swallowing event within timeframe");
-          evt = next;
-        }
-      }
-
-      if (evt.type == event_type::UPDATE) {
-        on(sig_ev::update{});
-      } else if (evt.type == event_type::INPUT) {
-        process_inputdata();
-      } else if (evt.type == event_type::QUIT) {
-        if (evt.flag) {
-          on(sig_ev::exit_reload{});
-        } else {
-          on(sig_ev::exit_terminate{});
-        }
-      } else if (evt.type == event_type::CHECK) {
-        on(sig_ev::check_state{});
+    } else if (evt.type == event_type::CHECK) {
+      on(sig_ev::check_state{});
+    } else if (evt.type == event_type::UPDATE) {
+      m_frame_forced = m_frame_forced || evt.flag;
+
+      if (chrono::steady_clock::now() - m_lastframe < m_frame_interval) {
+        m_log.trace_x("controller: Postponing update until next frame");
+        m_frame_pending = true;
       } else {
-        m_log.warn("Unknown event type for enqueued event (%d)", evt.type);
+        bool force{m_frame_forced};
+        m_frame_pending = false;
+        m_frame_forced = false;
+        m_lastframe = chrono::steady_clock::now();
+        on(sig_ev::update{move(force)});
       }
+    } else {
+      m_log.warn("Unknown event type for enqueued event (%d)", evt.type);
     }
   }
 }
@@ -411,18 +467,72 @@ bool controller::on(const sig_ev::notify_change&) {
 
 /**
  * Process eventqueue update event
+ *
+ * Only the output of changed modules is fetched and only the
+ * blocks containing them are put together again
  */
-bool controller::on(const sig_ev::update&) {
+bool controller::on(const sig_ev::update& evt) {
+  bool force{*evt()};
+  bool changed{false};
+  bool compile{m_parser && !m_writeback};
+
   const bar_settings& bar{m_bar->settings()};
-  string contents;
   string separator{bar.separator};
   string padding_left(bar.padding.left, ' ');
   string padding_right(bar.padding.right, ' ');
   string margin_left(bar.module_margin.left, ' ');
   string margin_right(bar.module_margin.right, ' ');
 
+  // Compiles a string into the given list, any invalid
+  // contents are dropped
+  auto compile_into = [&](const string& data, drawlist& list) {
+    try {
+      m_parser->compile(bar, data, list);
+    } catch (const parser_error& err) {
+      m_log.err("Failed to parse contents (reason: %s)", err.what());
+      list.clear();
+    }
+  };
+
+  drawlist separator_list;
+  drawlist margin_left_list;
+  drawlist margin_right_list;
+  drawlist padding_left_list;
+  drawlist padding_right_list;
+
+  if (compile) {
+    compile_into(separator, separator_list);
+    compile_into(margin_left, margin_left_list);
+    compile_into(margin_right, margin_right_list);
+    compile_into(padding_left, padding_left_list);
+    compile_into(padding_right, padding_right_list);
+  }
+
   for (const auto& block : m_modules) {
+    bool block_changed{force || m_blocks.find(block.first) == m_blocks.end()};
+
+    for (const auto& module : block.second) {
+      if (module->changed() || m_fragments.find(module.get()) == m_fragments.end()) {
+        string& fragment{m_fragments[module.get()]};
+        fragment = merge_tags(module->contents());
+        block_changed = true;
+
+        if (compile) {
+          drawlist& list{m_fragmentlists[module.get()]};
+          list.clear();
+          compile_into(fragment, list);
+        }
+      }
+    }
+
+    if (!block_changed) {
+      continue;
+    }
+
+    changed = true;
+
     string block_contents;
+    drawlist block_list;
     bool is_left = false;
     bool is_center = false;
     bool is_right = false;
@@ -435,27 +545,43 @@ bool controller::on(const sig_ev::update&) {
       is_right = true;
     }
 
+    auto append = [&](const string& str, const drawlist& list) {
+      block_contents += str;
+      if (compile) {
+        block_list.append(list);
+      }
+    };
+
     for (const auto& module : block.second) {
-      string module_contents{module->contents()};
+      const string& module_contents{m_fragments[module.get()]};
 
       if (module_contents.empty()) {
         continue;
       }
 
       if (!block_contents.empty() && !margin_right.empty()) {
-        block_contents += margin_right;
+        append(margin_right, margin_right_list);
       }
 
       if (!block_contents.empty() && !separator.empty()) {
-        block_contents += separator;
+        append(separator, separator_list);
       }
 
       if (!block_contents.empty() && !margin_left.empty() && !(is_left && module == block.second.front())) {
-        block_contents += margin_left;
+        append(margin_left, margin_left_list);
       }
 
-      block_contents.reserve(module_contents.size());
       block_contents += module_contents;
+      if (compile) {
+        block_list.append(m_fragmentlists[module.get()]);
+      }
+    }
+
+    string& contents{m_blocks[block.first]};
+    contents.clear();
+
+    if (compile) {
+      m_blocklists[block.first].clear();
     }
 
     if (block_contents.empty()) {
@@ -467,26 +593,45 @@ bool controller::on(const sig_ev::update&) {
       contents += "%{c}";
     } else if (is_right) {
       contents += "%{r}";
-      block_contents += padding_right;
+      append(padding_right, padding_right_list);
     }
 
-    // Strip unnecessary reset tags
-    block_contents = string_util::replace_all(block_contents, "T-}%{T", "T");
-    block_contents = string_util::replace_all(block_contents, "B-}%{B#", "B#");
-    block_contents = string_util::replace_all(block_contents, "F-}%{F#", "F#");
-    block_contents = string_util::replace_all(block_contents, "U-}%{U#", "U#");
-    block_contents = string_util::replace_all(block_contents, "u-}%{u#", "u#");
-    block_contents = string_util::replace_all(block_contents, "o-}%{o#", "o#");
+    contents += block_contents;
 
-    // Join consecutive tags
-    contents += string_util::replace_all(block_contents, "}%{", " ");
+    if (compile) {
+      drawlist& contents_list{m_blocklists[block.first]};
+      contents_list.align(block.first);
+      if (is_left) {
+        contents_list.append(padding_left_list);
+      }
+      contents_list.append(block_list);
+    }
+  }
+
+  if (!changed) {
+    m_log.trace_x("controller: Skipping frame (no module changed)");
+    return true;
   }
 
   try {
+    if (compile) {
+      m_drawlist.clear();
+      for (const auto& block : m_blocklists) {
+        m_drawlist.append(block.second);
+      }
+      m_bar->render(m_drawlist);
+      return true;
+    }
+
+    m_contents.clear();
+    for (const auto& block : m_blocks) {
+      m_contents += block.second;
+    }
+
     if (!m_writeback) {
-      m_bar->parse(move(contents));
+      m_bar->parse(m_contents);
     } else {
-      std::cout << contents << std::endl;
+      std::cout << m_contents << std::endl;
     }
   } catch (const exception& err) {
     m_log.err("Failed to update bar contents (reason: %s)", err.what());
@@ -0,0 +1,140 @@
+#include "components/drawlist.hpp"
+
+POLYBAR_NS
+
+void drawlist::background(uint32_t color) {
+  push(drawop::BACKGROUND, color);
+}
+
+void drawlist::foreground(uint32_t color) {
+  push(drawop::FOREGROUND, color);
+}
+
+void drawlist::underline(uint32_t color) {
+  push(drawop::UNDERLINE, color);
+}
+
+void drawlist::overline(uint32_t color) {
+  push(drawop::OVERLINE, color);
+}
+
+void drawlist::font(uint8_t index) {
+  push(drawop::FONT, index);
+}
+
+void drawlist::align(alignment align) {
+  push(drawop::ALIGNMENT, static_cast<uint32_t>(align));
+}
+
+void drawlist::offset(int16_t pixels) {
+  push(drawop::OFFSET, static_cast<uint16_t>(pixels));
+}
+
+void drawlist::attribute_set(attribute attr) {
+  push(drawop::ATTRIBUTE_SET, static_cast<uint32_t>(attr));
+}
+
+void drawlist::attribute_unset(attribute attr) {
+  push(drawop::ATTRIBUTE_UNSET, static_cast<uint32_t>(attr));
+}
+
+void drawlist::attribute_toggle(attribute attr) {
+  push(drawop::ATTRIBUTE_TOGGLE, static_cast<uint32_t>(attr));
+}
+
+void drawlist::action_begin(mousebtn btn, string command) {
+  push(drawop::ACTION_BEGIN, m_actions.size());
+  m_actions.emplace_back(action{btn, move(command)});
+}
+
+void drawlist::action_end(mousebtn btn) {
+  push(drawop::ACTION_END, static_cast<uint32_t>(btn));
+}
+
+/**
+ * Add text run, consecutive runs are merged
+ */
+void drawlist::text(const uint32_t* data, size_t length) {
+  if (!length) {
+    return;
+  }
+
+  if (m_ops.empty() || m_ops.back().type != drawop::TEXT) {
+    m_ops.emplace_back(op{drawop::TEXT, static_cast<uint32_t>(m_text.size()), 0U});
+  }
+
+  m_text.insert(m_text.end(), data, data + length);
+  m_ops.back().length += length;
+}
+
+/**
+ * Append the operations of another list
+ */
+void drawlist::append(const drawlist& other) {
+  m_ops.reserve(m_ops.size() + other.m_ops.size());
+
+  for (auto&& o : other.m_ops) {
+    if (o.type == drawop::TEXT) {
+      text(other.text(o), o.length);
+    } else if (o.type == drawop::ACTION_BEGIN) {
+      const auto& a = other.get_action(o);
+      action_begin(a.button, a.command);
+    } else {
+      m_ops.emplace_back(o);
+    }
+  }
+}
+
+void drawlist::clear() {
+  m_ops.clear();
+  m_text.clear();
+  m_actions.clear();
+}
+
+bool drawlist::empty() const {
+  return m_ops.empty();
+}
+
+size_t drawlist::size() const {
+  return m_ops.size();
+}
+
+const vector<drawlist::op>& drawlist::ops() const {
+  return m_ops;
+}
+
+/**
+ * Get the characters of a text operation
+ */
+const uint32_t* drawlist::text(const op& o) const {
+  return m_text.data() + o.value;
+}
+
+/**
+ * Get the action started by an action operation
+ */
+const action& drawlist::get_action(const op& o) const {
+  return m_actions[o.value];
+}
+
+bool drawlist::operator==(const drawlist& other) const {
+  if (m_ops != other.m_ops || m_text != other.m_text || m_actions.size() != other.m_actions.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < m_actions.size(); i++) {
+    if (m_actions[i].button != other.m_actions[i].button || m_actions[i].command != other.m_actions[i].command) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool drawlist::operator!=(const drawlist& other) const {
+  return !(*this == other);
+}
+
+void drawlist::push(drawop type, uint32_t value) {
+  m_ops.emplace_back(op{type, value, 0U});
+}
+
+POLYBAR_NS_END
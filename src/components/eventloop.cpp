@@ -0,0 +1,100 @@
+#include <unistd.h>
+
+#include "components/eventloop.hpp"
+#include "errors.hpp"
+#include "utils/factory.hpp"
+
+POLYBAR_NS
+
+/**
+ * Create instance
+ */
+eventloop::make_type eventloop::make() {
+  return factory_util::unique<eventloop>();
+}
+
+/**
+ * Construct event loop
+ */
+eventloop::eventloop() {
+  if ((m_fd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+    throw system_error("Failed to create epoll instance");
+  }
+}
+
+/**
+ * Deconstruct event loop
+ */
+eventloop::~eventloop() {
+  if (m_fd != -1) {
+    close(m_fd);
+  }
+}
+
+/**
+ * Register callback for events on given file descriptor
+ *
+ * Attaching an already registered descriptor replaces
+ * its callback and event mask
+ */
+void eventloop::attach(int fd, callback fn, uint32_t events) {
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  struct epoll_event evt {};
+  evt.events = events;
+  evt.data.fd = fd;
+
+  if (epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &evt) == -1) {
+    if (errno != EEXIST || epoll_ctl(m_fd, EPOLL_CTL_MOD, fd, &evt) == -1) {
+      throw system_error("Failed to attach file descriptor to event loop");
+    }
+  }
+
+  m_callbacks[fd] = move(fn);
+}
+
+/**
+ * Unregister file descriptor
+ *
+ * The descriptor might already be closed, in which case
+ * the kernel has removed it from the set
+ */
+void eventloop::detach(int fd) {
+  std::lock_guard<std::mutex> guard(m_lock);
+  epoll_ctl(m_fd, EPOLL_CTL_DEL, fd, nullptr);
+  m_callbacks.erase(fd);
+}
+
+/**
+ * Wait for events and dispatch them to the registered callbacks
+ *
+ * @brief A timeout_ms of -1 blocks until an event is fired
+ * @return false if waiting failed
+ */
+bool eventloop::poll(int timeout_ms) {
+  struct epoll_event events[MAX_EVENTS];
+  int count{epoll_wait(m_fd, events, MAX_EVENTS, timeout_ms)};
+
+  if (count == -1) {
+    return errno == EINTR;
+  }
+
+  for (int i = 0; i < count; i++) {
+    callback fn;
+    {
+      // Callbacks are invoked without holding the lock so that they
+      // are free to attach or detach descriptors themselves
+      std::lock_guard<std::mutex> guard(m_lock);
+      auto it = m_callbacks.find(events[i].data.fd);
+      if (it == m_callbacks.end()) {
+        continue;
+      }
+      fn = it->second;
+    }
+    fn(events[i].events);
+  }
+
+  return true;
+}
+
+POLYBAR_NS_END
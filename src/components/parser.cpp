@@ -1,44 +1,45 @@
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
+#include "components/drawlist.hpp"
 #include "components/parser.hpp"
 #include "components/types.hpp"
-#include "events/signal.hpp"
-#include "events/signal_emitter.hpp"
 #include "utils/color.hpp"
+#include "utils/factory.hpp"
 #include "utils/math.hpp"
 #include "utils/memory.hpp"
 #include "utils/string.hpp"
 
 POLYBAR_NS
 
-using namespace signals::parser;
-
 /**
  * Create instance
  */
 parser::make_type parser::make() {
-  return factory_util::unique<parser>(signal_emitter::make());
+  return factory_util::unique<parser>();
 }
 
 /**
- * Construct parser instance
+ * Compile input string into a list of drawing operations
+ *
+ * The input is processed in a single forward pass, text is
+ * decoded run by run into a reusable codepoint buffer
  */
-parser::parser(signal_emitter& emitter) : m_sig(emitter) {}
+void parser::compile(const bar_settings& bar, const string& data, drawlist& output) {
+  const char* pos{data.data()};
+  const char* end{pos + data.size()};
 
-/**
- * Process input string
- */
-void parser::parse(const bar_settings& bar, string data) {
-  while (!data.empty()) {
-    size_t pos{string::npos};
-
-    if (data.compare(0, 2, "%{") == 0 && (pos = data.find('}')) != string::npos) {
-      codeblock(data.substr(2, pos - 2), bar);
-      data.erase(0, pos + 1);
-    } else if ((pos = data.find("%{")) != string::npos) {
-      data.erase(0, text(data.substr(0, pos)));
+  m_actions.clear();
+
+  while (pos != end) {
+    const char* close{end};
+
+    if (end - pos > 2 && pos[0] == '%' && pos[1] == '{' && (close = std::find(pos + 2, end, '}')) != end) {
+      codeblock(pos + 2, close, bar, output);
+      pos = close + 1;
     } else {
-      data.erase(0, text(data.substr(0)));
+      pos = text(pos, end, output);
     }
   }
 
@@ -50,101 +51,93 @@ void parser::parse(const bar_settings& bar, string data) {
 /**
  * Process contents within tag blocks, i.e: %{...}
  */
-void parser::codeblock(string&& data, const bar_settings& bar) {
-  size_t pos;
-
-  while (data.length()) {
-    data = string_util::ltrim(move(data), ' ');
-
-    if (data.empty()) {
-      break;
+void parser::codeblock(const char* pos, const char* end, const bar_settings& bar, drawlist& output) {
+  while (pos != end) {
+    if (*pos == ' ') {
+      pos++;
+      continue;
     }
 
-    char tag{data[0]};
-    string value;
-
-    // Remove the tag
-    data.erase(0, 1);
-
-    if ((pos = data.find_first_of(" }")) != string::npos) {
-      value = data.substr(0, pos);
-    } else {
-      value = data;
-    }
+    char tag{*pos++};
+    const char* value{pos};
+    pos = std::find(pos, end, ' ');
 
     switch (tag) {
       case 'B':
-        m_sig.emit(change_background{parse_color(value, bar.background)});
+        output.background(parse_color(value, pos, bar.background));
         break;
 
       case 'F':
-        m_sig.emit(change_foreground{parse_color(value, bar.foreground)});
+        output.foreground(parse_color(value, pos, bar.foreground));
         break;
 
       case 'T':
-        m_sig.emit(change_font{parse_fontindex(value)});
+        output.font(parse_fontindex(value, pos));
         break;
 
       case 'U':
-        m_sig.emit(change_underline{parse_color(value, bar.underline.color)});
-        m_sig.emit(change_overline{parse_color(value, bar.overline.color)});
+        output.underline(parse_color(value, pos, bar.underline.color));
+        output.overline(parse_color(value, pos, bar.overline.color));
         break;
 
       case 'u':
-        m_sig.emit(change_underline{parse_color(value, bar.underline.color)});
+        output.underline(parse_color(value, pos, bar.underline.color));
         break;
 
       case 'o':
-        m_sig.emit(change_overline{parse_color(value, bar.overline.color)});
+        output.overline(parse_color(value, pos, bar.overline.color));
         break;
 
       case 'R':
-        m_sig.emit(change_background{parse_color(value, bar.foreground)});
-        m_sig.emit(change_foreground{parse_color(value, bar.background)});
+        output.background(parse_color(value, pos, bar.foreground));
+        output.foreground(parse_color(value, pos, bar.background));
         break;
 
       case 'O':
-        m_sig.emit(offset_pixel{static_cast<int16_t>(std::atoi(value.c_str()))});
+        output.offset(static_cast<int16_t>(std::atoi(value)));
         break;
 
       case 'l':
-        m_sig.emit(change_alignment{alignment::LEFT});
+        output.align(alignment::LEFT);
         break;
 
       case 'c':
-        m_sig.emit(change_alignment{alignment::CENTER});
+        output.align(alignment::CENTER);
         break;
 
       case 'r':
-        m_sig.emit(change_alignment{alignment::RIGHT});
+        output.align(alignment::RIGHT);
         break;
 
       case '+':
-        m_sig.emit(attribute_set{parse_attr(value[0])});
+        output.attribute_set(parse_attr(value != end ? *value : '\0'));
         break;
 
       case '-':
-        m_sig.emit(attribute_unset{parse_attr(value[0])});
+        output.attribute_unset(parse_attr(value != end ? *value : '\0'));
         break;
 
       case '!':
-        m_sig.emit(attribute_toggle{parse_attr(value[0])});
+        output.attribute_toggle(parse_attr(value != end ? *value : '\0'));
         break;
 
       case 'A':
-        if (isdigit(data[0]) || data[0] == ':') {
-          value = parse_action_cmd(data.substr(data[0] != ':' ? 1 : 0));
-          mousebtn btn = parse_action_btn(data);
+        if (value != end && (isdigit(*value) || *value == ':')) {
+          // The command may contain spaces, so it
+          // ends at the closing colon instead
+          mousebtn btn{parse_action_btn(*value)};
+          const char* cmd{*value == ':' ? value : value + 1};
+          pos = parse_action_cmd(cmd, end);
           m_actions.push_back(static_cast<int>(btn));
-          m_sig.emit(action_begin{action{btn, value}});
 
-          // make sure we strip the correct length (btn+wrapping colons)
-          if (value[0] != ':') {
-            value += "0";
+          if (pos != end) {
+            output.action_begin(btn, string(cmd + 1, pos));
+            pos++;
+          } else {
+            output.action_begin(btn, "");
           }
-          value += "::";
         } else if (!m_actions.empty()) {
-          m_sig.emit(action_end{parse_action_btn(value)});
+          output.action_end(parse_action_btn(value != end ? *value : '\0'));
           m_actions.pop_back();
         }
         break;
@@ -152,79 +145,84 @@ void parser::codeblock(string&& data, const bar_settings& bar) {
       default:
         throw unrecognized_token("Unrecognized token '" + string{tag} + "'");
     }
-
-    if (!data.empty()) {
-      data.erase(0, !value.empty() ? value.length() : 1);
-    }
   }
 }
 
 /**
- * Process text contents
+ * Process text contents up to the next tag block
  */
-size_t parser::text(string&& data) {
-  const uint8_t* utf{reinterpret_cast<const uint8_t*>(&data[0])};
-
-  // clang-format off
-  if (utf[0] < 0x80) {
-    size_t pos{0};
-
-    // grab consecutive ascii chars
-    while (utf[pos] && utf[pos] < 0x80) {
-      packet pkt{};
-      size_t limit{memory_util::countof(pkt.data)};
-      size_t len{0};
-
-      while (len + 1 < limit && utf[pos] && utf[pos] < 0x80) {
-        pkt.data[len++] = utf[pos++];
+const char* parser::text(const char* pos, const char* end, drawlist& output) {
+  m_chars.clear();
+
+  // The first character is always consumed so that an unclosed tag ends up as text
+  do {
+    // Take eight ascii characters at a time while none of them can start a tag
+    if (end - pos >= 8) {
+      uint64_t block;
+      std::memcpy(&block, pos, sizeof(block));
+
+      const uint64_t tag{block ^ 0x2525252525252525ULL};
+      const bool has_tag{((tag - 0x0101010101010101ULL) & ~tag & 0x8080808080808080ULL) != 0};
+
+      if (!(block & 0x8080808080808080ULL) && !has_tag) {
+        m_chars.insert(m_chars.end(), pos, pos + 8);
+        pos += 8;
+        continue;
       }
+    }
 
-      if (!len) {
-        break;
-      }
+    const uint8_t* utf{reinterpret_cast<const uint8_t*>(pos)};
 
-      pkt.length = len;
-      m_sig.emit(write_text_string{move(pkt)});
+    if (utf[0] < 0x80) {
+      m_chars.emplace_back(*pos++);
+      continue;
     }
 
-    if (pos > 0) {
-      return pos;
+    uint32_t chr{0xfffd};
+    size_t len{1};
+
+    // clang-format off
+    if ((utf[0] & 0xe0) == 0xc0) {  // 2 byte utf-8 sequence
+      len = 2;
+    } else if ((utf[0] & 0xf0) == 0xe0) {  // 3 byte utf-8 sequence
+      len = 3;
+    } else if ((utf[0] & 0xf8) == 0xf0) {  // 4 byte utf-8 sequence
+      len = 4;
+    } else if ((utf[0] & 0xfc) == 0xf8) {  // 5 byte utf-8 sequence
+      len = 5;
+    } else if ((utf[0] & 0xfe) == 0xfc) {  // 6 byte utf-8 sequence
+      len = 6;
+    } else {
+      pos++;
+      continue;
     }
 
-  } else if ((utf[0] & 0xe0) == 0xc0) {  // 2 byte utf-8 sequence
-    m_sig.emit(write_text_unicode{static_cast<uint16_t>(((utf[0] & 0x1f) << 6) | (utf[1] & 0x3f))});
-    return 2;
-  } else if ((utf[0] & 0xf0) == 0xe0) {  // 3 byte utf-8 sequence
-    m_sig.emit(write_text_unicode{static_cast<uint16_t>(((utf[0] & 0x0f) << 12) | ((utf[1] & 0x3f) << 6) | (utf[2] & 0x3f))});
-    return 3;
-  } else if ((utf[0] & 0xf8) == 0xf0) {  // 4 byte utf-8 sequence
-    // m_sig.emit(write_text_unicode{((utf[0] & 0x07) << 18) | ((utf[1] & 0x3f) << 12) | ((utf[2] & 0x3f) << 6) | (utf[3] & 0x3f)});
-    m_sig.emit(write_text_unicode{static_cast<uint16_t>(0xfffd)});
-    return 4;
-  } else if ((utf[0] & 0xfc) == 0xf8) {  // 5 byte utf-8 sequence
-    // m_sig.emit(write_text_unicode{((utf[0] & 0x03) << 24) | ((utf[1] & 0x3f) << 18) | ((utf[2] & 0x3f) << 12) | ((utf[3] & 0x3f) << 6) | (utf[4] & 0x3f)});
-    m_sig.emit(write_text_unicode{static_cast<uint16_t>(0xfffd)});
-    return 5;
-  } else if ((utf[0] & 0xfe) == 0xfc) {  // 6 byte utf-8 sequence
-    // m_sig.emit(write_text_unicode{((utf[0] & 0x01) << 30) | ((utf[1] & 0x3f) << 24) | ((utf[2] & 0x3f) << 18) | ((utf[3] & 0x3f) << 12) | ((utf[4] & 0x3f) << 6) | (utf[5] & 0x3f)});
-    m_sig.emit(write_text_unicode{static_cast<uint16_t>(0xfffd)});
-    return 6;
-  }
-  // clang-format on
+    if (static_cast<size_t>(end - pos) < len) {
+      len = end - pos;
+    } else if (len == 2) {
+      chr = ((utf[0] & 0x1f) << 6) | (utf[1] & 0x3f);
+    } else if (len == 3) {
+      chr = ((utf[0] & 0x0f) << 12) | ((utf[1] & 0x3f) << 6) | (utf[2] & 0x3f);
+    } else if (len == 4) {
+      chr = ((utf[0] & 0x07) << 18) | ((utf[1] & 0x3f) << 12) | ((utf[2] & 0x3f) << 6) | (utf[3] & 0x3f);
+    }
+    // clang-format on
 
-  if (utf[0] < 0x80) {
-    m_sig.emit(write_text_ascii{utf[0]});
-  }
+    m_chars.emplace_back(chr > 0x10ffff ? 0xfffd : chr);
+    pos += len;
+  } while (pos != end && !(pos[0] == '%' && pos + 1 != end && pos[1] == '{'));
 
-  return 1;
+  output.text(m_chars.data(), m_chars.size());
+
+  return pos;
 }
 
 /**
  * Process color hex string and convert it to the correct value
  */
-uint32_t parser::parse_color(const string& s, uint32_t fallback) {
+uint32_t parser::parse_color(const char* begin, const char* end, uint32_t fallback) {
   uint32_t color{0};
-  if (s.empty() || s[0] == '-' || (color = color_util::parse(s, fallback)) == fallback) {
+  if (begin == end || *begin == '-' || (color = color_util::parse(string(begin, end), fallback)) == fallback) {
     return fallback;
   }
   return color_util::premultiply_alpha(color);
@@ -233,16 +231,12 @@ uint32_t parser::parse_color(const string& s, uint32_t fallback) {
 /**
  * Process font index and convert it to the correct value
  */
-uint8_t parser::parse_fontindex(const string& s) {
-  if (s.empty() || s[0] == '-') {
-    return 0;
-  }
-
-  try {
-    return std::stoul(s, nullptr, 10);
-  } catch (const std::invalid_argument& err) {
-    return 0;
+uint8_t parser::parse_fontindex(const char* begin, const char* end) {
+  uint8_t index{0};
+  while (begin != end && isdigit(*begin)) {
+    index = index * 10 + (*begin++ - '0');
   }
+  return index;
 }
 
 /**
@@ -262,11 +256,11 @@ attribute parser::parse_attr(const char attr) {
 /**
  * Process action button token and convert it to the correct value
  */
-mousebtn parser::parse_action_btn(const string& data) {
-  if (data[0] == ':') {
+mousebtn parser::parse_action_btn(const char btn) {
+  if (btn == ':') {
     return mousebtn::LEFT;
-  } else if (isdigit(data[0])) {
-    return static_cast<mousebtn>(data[0] - '0');
+  } else if (isdigit(btn)) {
+    return static_cast<mousebtn>(btn - '0');
   } else if (!m_actions.empty()) {
     return static_cast<mousebtn>(m_actions.back());
   } else {
@@ -275,23 +269,20 @@ mousebtn parser::parse_action_btn(const string& data) {
 }
 
 /**
- * Process action command string
+ * Find the end of an action command starting
+ * at the opening colon, escaped colons are skipped
  */
-string parser::parse_action_cmd(string&& data) {
-  if (data[0] != ':') {
-    return "";
-  }
-
-  size_t end{1};
-  while ((end = data.find(':', end)) != string::npos && data[end - 1] == '\\') {
-    end++;
+const char* parser::parse_action_cmd(const char* begin, const char* end) {
+  if (begin == end || *begin != ':') {
+    return end;
   }
 
-  if (end == string::npos) {
-    return "";
+  const char* pos{begin + 1};
+  while ((pos = std::find(pos, end, ':')) != end && pos[-1] == '\\') {
+    pos++;
   }
 
-  return data.substr(1, end - 1);
+  return pos;
 }
 
 POLYBAR_NS_END
@@ -1,13 +1,16 @@
+#include <algorithm>
+#include <unordered_map>
+
+#include "components/drawlist.hpp"
 #include "components/renderer.hpp"
 #include "components/logger.hpp"
 #include "errors.hpp"
-#include "events/signal.hpp"
-#include "events/signal_emitter.hpp"
-#include "events/signal_receiver.hpp"
+#include "utils/factory.hpp"
 #include "x11/connection.hpp"
 #include "x11/draw.hpp"
 #include "x11/extensions/all.hpp"
 #include "x11/generic.hpp"
+#include "x11/surface.hpp"
 #include "x11/winspec.hpp"
 #include "x11/xlib.hpp"
 #include "x11/xutils.hpp"
@@ -21,7 +24,6 @@ renderer::make_type renderer::make(const bar_settings& bar, vector<string>&& fon
   // clang-format off
   return factory_util::unique<renderer>(
       connection::make(),
-      signal_emitter::make(),
       logger::make(),
       font_manager::make(),
       forward<decltype(bar)>(bar),
@@ -32,16 +34,13 @@ renderer::make_type renderer::make(const bar_settings& bar, vector<string>&& fon
 /**
  * Construct renderer instance
  */
-renderer::renderer(connection& conn, signal_emitter& emitter, const logger& logger,
-    unique_ptr<font_manager> font_manager, const bar_settings& bar, const vector<string>& fonts)
+renderer::renderer(connection& conn, const logger& logger, unique_ptr<font_manager> font_manager,
+    const bar_settings& bar, const vector<string>& fonts)
     : m_connection(conn)
-    , m_sig(emitter)
     , m_log(logger)
     , m_fontmanager(forward<decltype(font_manager)>(font_manager))
     , m_bar(forward<const bar_settings&>(bar))
     , m_rect(m_bar.inner_area()) {
-  m_sig.attach(this);
-
   m_log.trace("renderer: Get TrueColor visual");
 
   if ((m_visual = m_connection.visual_type(m_connection.screen(), 32)) == nullptr) {
@@ -90,6 +89,11 @@ renderer::renderer(connection& conn, signal_emitter& emitter, const logger& logg
   m_pixmap = m_connection.generate_id();
   m_connection.create_pixmap(m_depth, m_pixmap, m_window, m_rect.width, m_rect.height);
 
+  if (m_bar.software_rendering) {
+    m_log.trace("renderer: Allocate client side surface");
+    m_surface = make_unique<surface>(m_connection, m_depth, m_rect.width, m_rect.height);
+  }
+
   m_log.trace("renderer: Allocate graphic contexts");
   {
     // clang-format off
@@ -115,6 +119,7 @@ renderer::renderer(connection& conn, signal_emitter& emitter, const logger& logg
       xutils::pack_values(mask, &params, value_list);
 
       m_colors.emplace(gc(i), colors[i]);
+      m_gccolors.emplace(gc(i), colors[i]);
       m_gcontexts.emplace(gc(i), m_connection.generate_id());
       m_connection.create_gc(m_gcontexts.at(gc(i)), m_pixmap, mask, value_list);
     }
@@ -160,8 +165,6 @@ renderer::renderer(connection& conn, signal_emitter& emitter, const logger& logg
  * Deconstruct instance
  */
 renderer::~renderer() {
-  m_sig.detach(this);
-
   if (m_window != XCB_NONE) {
     m_connection.destroy_window(m_window);
   }
@@ -185,21 +188,51 @@ void renderer::begin() {
   m_currentx = 0;
   m_attributes = 0;
   m_actions.clear();
+  m_openactions.clear();
+  m_frame.primitives.clear();
+  m_frame.chars.clear();
+
+  set_background(m_bar.background);
+  set_foreground(m_bar.foreground);
+  set_underline(m_bar.underline.color);
+  set_overline(m_bar.overline.color);
 }
 
 /**
  * End render routine
+ *
+ * Only the areas that differ from the previous
+ * frame are cleared, redrawn and copied to the window
  */
 void renderer::end() {
   m_log.trace_x("renderer: end");
 
+  m_frame.rect = m_rect;
+  damage();
+  paint();
+
   m_fontmanager->cleanup();
 
+  // Publish the clickable areas of the finished frame to the input handler
+  std::atomic_store(&m_actionindex, make_shared<const action_index>(m_actions));
+
 #ifdef DEBUG_HINTS
   debug_hints();
 #endif
 
-  flush(false);
+  if (m_invalidated) {
+    flush(false);
+  } else if (!m_damage.empty()) {
+    for (auto&& area : m_damage) {
+      m_log.trace_x("renderer: copy damaged area (x=%i, w=%i)", area.first, area.second - area.first);
+      m_connection.copy_area(m_pixmap, m_window, m_gcontexts.at(gc::FG), area.first, 0, m_rect.x + area.first,
+          m_rect.y, area.second - area.first, m_rect.height);
+    }
+    m_connection.flush();
+  }
+
+  std::swap(m_frame, m_prevframe);
+  m_invalidated = false;
 }
 
 /**
@@ -286,6 +319,7 @@ void renderer::flush(bool clear) {
 
   if (clear) {
     m_connection.clear_area(false, m_pixmap, 0, 0, r.width, r.height);
+    m_invalidated = true;
   }
 
   m_connection.flush();
@@ -327,18 +361,224 @@ void renderer::reserve_space(edge side, uint16_t w) {
 }
 
 /**
- * Check if given attribute is enabled
+ * Render compiled contents
+ *
+ * The contents are measured first so that each
+ * text run can be drawn once at its final position
  */
-bool renderer::check_attribute(const attribute attr) {
-  return (m_attributes >> static_cast<uint8_t>(attr)) & 1U;
+void renderer::render(const drawlist& list) {
+  m_log.trace_x("renderer: render(%lu ops)", list.size());
+  measure(list);
+  draw(list);
 }
 
 /**
- * Fill background color
+ * Match glyphs and calculate the position of each alignment block
  */
-void renderer::fill_background() {
-  m_log.trace_x("renderer: fill_background");
-  draw_util::fill(m_connection, m_pixmap, m_gcontexts.at(gc::BG), 0, 0, m_rect.width, m_rect.height);
+void renderer::measure(const drawlist& list) {
+  map<alignment, int> widths;
+  alignment align{alignment::NONE};
+
+  m_glyphs.clear();
+  m_glyphpos = 0;
+  set_fontindex(0);
+
+  for (auto&& o : list.ops()) {
+    switch (o.type) {
+      case drawop::FONT:
+        set_fontindex(static_cast<uint8_t>(o.value));
+        break;
+      case drawop::ALIGNMENT:
+        align = static_cast<alignment>(o.value);
+        break;
+      case drawop::OFFSET:
+        widths[align] += static_cast<int16_t>(o.value);
+        break;
+      case drawop::TEXT: {
+        const uint32_t* chars{list.text(o)};
+        size_t first{m_glyphs.size()};
+
+        for (size_t i = 0; i < o.length; i++) {
+          m_glyphs.emplace_back(glyph{m_fontmanager->match_char(chars[i]), 0U});
+        }
+
+        // Measure each run of characters sharing the same font at once
+        for (size_t i = 0, j = 0; i < o.length; i = j) {
+          const auto& font = m_glyphs[first + i].font;
+
+          for (j = i + 1; j < o.length && m_glyphs[first + j].font == font; j++) {
+          }
+
+          if (!font) {
+            m_log.warn("Could not find glyph for %i", chars[i]);
+            continue;
+          }
+
+          const text_run& run{m_fontmanager->measure(font, chars + i, j - i)};
+
+          for (size_t n = i; n < j; n++) {
+            m_glyphs[first + n].width = run.advances[n - i];
+          }
+
+          widths[align] += run.width;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  m_blockx[alignment::NONE] = 0;
+  m_blockx[alignment::LEFT] = 0;
+  m_blockx[alignment::CENTER] = static_cast<int16_t>(m_rect.width / 2 - widths[alignment::CENTER] / 2);
+  m_blockx[alignment::RIGHT] = static_cast<int16_t>(m_rect.width - widths[alignment::RIGHT]);
+}
+
+/**
+ * Draw the contents at the positions found while measuring
+ */
+void renderer::draw(const drawlist& list) {
+  m_currentx = m_blockx[m_alignment];
+
+  for (auto&& o : list.ops()) {
+    switch (o.type) {
+      case drawop::BACKGROUND:
+        set_background(o.value);
+        break;
+      case drawop::FOREGROUND:
+        set_foreground(o.value);
+        break;
+      case drawop::UNDERLINE:
+        set_underline(o.value);
+        break;
+      case drawop::OVERLINE:
+        set_overline(o.value);
+        break;
+      case drawop::FONT:
+        break;
+      case drawop::ALIGNMENT:
+        set_alignment(static_cast<alignment>(o.value));
+        break;
+      case drawop::OFFSET:
+        fill_offset(static_cast<int16_t>(o.value));
+        break;
+      case drawop::ATTRIBUTE_SET:
+        set_attribute(static_cast<attribute>(o.value), true);
+        break;
+      case drawop::ATTRIBUTE_UNSET:
+        set_attribute(static_cast<attribute>(o.value), false);
+        break;
+      case drawop::ATTRIBUTE_TOGGLE:
+        toggle_attribute(static_cast<attribute>(o.value));
+        break;
+      case drawop::ACTION_BEGIN:
+        begin_action(list.get_action(o).button, list.get_action(o).command);
+        break;
+      case drawop::ACTION_END:
+        end_action(static_cast<mousebtn>(o.value));
+        break;
+      case drawop::TEXT:
+        draw_textstring(list.text(o), o.length);
+        break;
+    }
+  }
+}
+
+/**
+ * Change background color
+ */
+void renderer::set_background(const uint32_t color) {
+  if (m_colors[gc::BG] == color) {
+    return m_log.trace_x("renderer: ignoring unchanged background color(#%08x)", color);
+  }
+  m_log.trace_x("renderer: set_background(#%08x)", color);
+  m_colors[gc::BG] = color;
+}
+
+/**
+ * Change foreground color
+ */
+void renderer::set_foreground(const uint32_t color) {
+  if (m_colors[gc::FG] == color) {
+    return m_log.trace_x("renderer: ignoring unchanged foreground color(#%08x)", color);
+  }
+  m_log.trace_x("renderer: set_foreground(#%08x)", color);
+  m_colors[gc::FG] = color;
+}
+
+/**
+ * Change underline color
+ */
+void renderer::set_underline(const uint32_t color) {
+  if (m_colors[gc::UL] == color) {
+    return m_log.trace_x("renderer: ignoring unchanged underline color(#%08x)", color);
+  }
+  m_log.trace_x("renderer: set_underline(#%08x)", color);
+  m_colors[gc::UL] = color;
+}
+
+/**
+ * Change overline color
+ */
+void renderer::set_overline(const uint32_t color) {
+  if (m_colors[gc::OL] == color) {
+    return m_log.trace_x("renderer: ignoring unchanged overline color(#%08x)", color);
+  }
+  m_log.trace_x("renderer: set_overline(#%08x)", color);
+  m_colors[gc::OL] = color;
+}
+
+/**
+ * Change preferred font index used when matching glyphs
+ */
+void renderer::set_fontindex(const uint8_t font) {
+  if (m_fontindex == font) {
+    return m_log.trace_x("renderer: ignoring unchanged font index(%i)", static_cast<uint8_t>(font));
+  }
+  m_log.trace_x("renderer: fontindex(%i)", static_cast<uint8_t>(font));
+  m_fontmanager->fontindex(font);
+  m_fontindex = font;
+}
+
+/**
+ * Change current alignment
+ */
+void renderer::set_alignment(const alignment align) {
+  if (align == m_alignment) {
+    return m_log.trace_x("renderer: ignoring unchanged alignment(%i)", static_cast<uint8_t>(align));
+  }
+  m_log.trace_x("renderer: set_alignment(%i)", static_cast<uint8_t>(align));
+  m_alignment = align;
+  m_currentx = m_blockx[align];
+}
+
+/**
+ * Enable or disable text attribute
+ */
+void renderer::set_attribute(const attribute attr, const bool state) {
+  m_log.trace_x("renderer: set_attribute(%i, %i)", static_cast<uint8_t>(attr), state);
+
+  if (state) {
+    m_attributes |= 1U << static_cast<uint8_t>(attr);
+  } else {
+    m_attributes &= ~(1U << static_cast<uint8_t>(attr));
+  }
+}
+
+/**
+ * Toggle text attribute
+ */
+void renderer::toggle_attribute(const attribute attr) {
+  m_log.trace_x("renderer: toggle_attribute(%i)", static_cast<uint8_t>(attr));
+  m_attributes ^= 1U << static_cast<uint8_t>(attr);
+}
+
+/**
+ * Check if given attribute is enabled
+ */
+bool renderer::check_attribute(const attribute attr) {
+  return (m_attributes >> static_cast<uint8_t>(attr)) & 1U;
 }
 
 /**
@@ -351,7 +591,7 @@ void renderer::fill_overline(int16_t x, uint16_t w) {
     return m_log.trace_x("renderer: not filling overline (size=0)");
   }
   m_log.trace_x("renderer: fill_overline(%i, #%08x)", m_bar.overline.size, m_colors[gc::OL]);
-  draw_util::fill(m_connection, m_pixmap, m_gcontexts.at(gc::OL), x, 0, w, m_bar.overline.size);
+  record_fill(gc::OL, x, 0, w, m_bar.overline.size);
 }
 
 /**
@@ -365,352 +605,402 @@ void renderer::fill_underline(int16_t x, uint16_t w) {
   }
   m_log.trace_x("renderer: fill_underline(%i, #%08x)", m_bar.underline.size, m_colors[gc::UL]);
   int16_t y{static_cast<int16_t>(m_rect.height - m_bar.underline.size)};
-  draw_util::fill(m_connection, m_pixmap, m_gcontexts.at(gc::UL), x, y, w, m_bar.underline.size);
+  record_fill(gc::UL, x, y, w, m_bar.underline.size);
 }
 
 /**
- * @see shift_content
+ * Fill background color of given area, unless it
+ * matches the bar background used to clear damaged areas
  */
-void renderer::fill_shift(const int16_t px) {
-  shift_content(px);
+void renderer::fill_background(int16_t x, uint16_t w) {
+  if (m_colors[gc::BG] == m_bar.background) {
+    return;
+  }
+  m_log.trace_x("renderer: fill_background(%i, %i, #%08x)", x, w, m_colors[gc::BG]);
+  record_fill(gc::BG, x, 0, w, m_rect.height);
+}
+
+/**
+ * Move the current position by given offset
+ */
+void renderer::fill_offset(const int16_t px) {
+  m_log.trace_x("renderer: fill_offset(%i)", px);
+  if (px > 0) {
+    fill_background(m_currentx, px);
+  }
+  m_currentx += px;
 }
 
 /**
  * Draw consecutive character glyphs
+ *
+ * Each run of glyphs sharing the same font is drawn with a
+ * single call and gets one background, underline and overline fill
  */
-void renderer::draw_textstring(const uint16_t* text, size_t len) {
+void renderer::draw_textstring(const uint32_t* text, size_t len) {
   m_log.trace_x("renderer: draw_textstring(\"%s\")", text);
 
-  for (size_t n = 0; n < len; n++) {
-    vector<uint16_t> chars{text[n]};
-    shared_ptr<font_ref> font{m_fontmanager->match_char(chars[0])};
-    uint8_t width{static_cast<const uint8_t>(m_fontmanager->glyph_width(font, chars[0]) * chars.size())};
+  for (size_t n = 0; n < len && m_glyphpos < m_glyphs.size();) {
+    const glyph& g{m_glyphs[m_glyphpos]};
 
-    if (!font) {
-      m_log.warn("Could not find glyph for %i", chars[0]);
-      continue;
-    } else if (!width) {
-      m_log.warn("Could not determine glyph width for %i", chars[0]);
+    if (!g.font || !g.width) {
+      n++;
+      m_glyphpos++;
       continue;
     }
 
-    while (n + 1 < len && text[n + 1] == chars[0]) {
-      chars.emplace_back(text[n++]);
-    }
-
-    width *= chars.size();
-    auto x = shift_content(width);
-    auto y = m_rect.height / 2 + font->height / 2 - font->descent + font->offset_y;
+    size_t count{0};
+    uint16_t width{0U};
 
-    if (font->ptr != XCB_NONE && m_gcfont != font->ptr) {
-      const uint32_t v[1]{font->ptr};
-      m_connection.change_gc(m_gcontexts.at(gc::FG), XCB_GC_FONT, v);
-      m_gcfont = font->ptr;
+    while (n + count < len && m_glyphpos < m_glyphs.size() && m_glyphs[m_glyphpos].font == g.font &&
+           m_glyphs[m_glyphpos].width) {
+      width += m_glyphs[m_glyphpos++].width;
+      count++;
     }
 
-    m_fontmanager->drawtext(font, m_pixmap, m_gcontexts.at(gc::FG), x, y, chars.data(), chars.size());
+    int16_t x{m_currentx};
+    int16_t y{static_cast<int16_t>(m_rect.height / 2 + g.font->height / 2 - g.font->descent + g.font->offset_y)};
 
+    fill_background(x, width);
+    record_text(g.font, x, y, width, text + n, count);
     fill_underline(x, width);
     fill_overline(x, width);
+
+    m_currentx += width;
+    n += count;
   }
 }
 
 /**
- * Get completed action blocks
+ * Compare the primitives of the current frame against the previous one
+ * and collect the horizontal spans that have to be redrawn
  */
-const vector<action_block> renderer::get_actions() {
-  return m_actions;
-}
+void renderer::damage() {
+  m_damage.clear();
 
-/**
- * Shift pixmap content by given value
- */
-int16_t renderer::shift_content(int16_t x, const int16_t shift_x) {
-  if (x > m_rect.width) {
-    return m_rect.width;
-  } else if (x < 0) {
-    return 0;
+  if (m_invalidated || m_frame.rect != m_prevframe.rect) {
+    m_log.trace_x("renderer: full damage");
+    m_invalidated = true;
+    m_damage.emplace_back(0, m_rect.width);
+    return;
   }
 
-  m_log.trace_x("renderer: shift_content(%i)", shift_x);
+  const auto hash = [](const frame& f, const primitive& p) {
+    size_t h{static_cast<size_t>(p.context)};
+    h = h * 31 + static_cast<uint16_t>(p.x);
+    h = h * 31 + static_cast<uint16_t>(p.y);
+    h = h * 31 + p.w;
+    h = h * 31 + p.h;
+    h = h * 31 + p.color;
+    for (size_t i = 0; i < p.length; i++) {
+      h = h * 31 + f.chars[p.text + i];
+    }
+    return h;
+  };
 
-  int16_t base_x{0};
-  double delta{0.0};
+  const auto equal = [](const frame& f1, const primitive& p1, const frame& f2, const primitive& p2) {
+    return p1.context == p2.context && p1.x == p2.x && p1.y == p2.y && p1.w == p2.w && p1.h == p2.h &&
+           p1.color == p2.color && p1.font == p2.font && p1.length == p2.length &&
+           std::equal(f1.chars.begin() + p1.text, f1.chars.begin() + p1.text + p1.length, f2.chars.begin() + p2.text);
+  };
 
-  switch (m_alignment) {
-    case alignment::NONE:
-      break;
-    case alignment::LEFT:
-      break;
-    case alignment::CENTER:
-      base_x = static_cast<int16_t>(m_rect.width / 2);
-      m_connection.copy_area(m_pixmap, m_pixmap, m_gcontexts.at(gc::FG), base_x - x / 2, 0, base_x - (x + shift_x) / 2,
-          0, x, m_rect.height);
-      x = base_x - (x + shift_x) / 2 + x;
-      delta = static_cast<double>(shift_x) / 2;
-      break;
-    case alignment::RIGHT:
-      base_x = static_cast<int16_t>(m_rect.width - x);
-      m_connection.copy_area(
-          m_pixmap, m_pixmap, m_gcontexts.at(gc::FG), base_x, 0, base_x - shift_x, 0, x, m_rect.height);
-      x = m_rect.width - shift_x;
-      delta = static_cast<double>(shift_x);
-      break;
+  std::unordered_multimap<size_t, const primitive*> previous;
+  previous.reserve(m_prevframe.primitives.size());
+
+  for (auto&& p : m_prevframe.primitives) {
+    previous.emplace(hash(m_prevframe, p), &p);
   }
 
-  draw_util::fill(m_connection, m_pixmap, m_gcontexts.at(gc::BG), x, 0, m_rect.width - x, m_rect.height);
+  for (auto&& p : m_frame.primitives) {
+    auto range = previous.equal_range(hash(m_frame, p));
+    auto match = std::find_if(range.first, range.second,
+        [&](const std::pair<const size_t, const primitive*>& it) { return equal(m_frame, p, m_prevframe, *it.second); });
 
-  // Translate pos of clickable areas
-  if (m_alignment != alignment::LEFT) {
-    for (auto&& action : m_actions) {
-      if (action.active || action.align != m_alignment) {
-        continue;
-      }
-      action.start_x -= delta;
-      action.end_x -= delta;
+    if (match != range.second) {
+      previous.erase(match);
+    } else {
+      damage(p.x, p.x + p.w);
     }
   }
 
-  m_currentx += shift_x;
-
-  return x;
-}
+  // Primitives that are gone leave their area dirty
+  for (auto&& it : previous) {
+    damage(it.second->x, it.second->x + it.second->w);
+  }
 
-/**
- * @see shift_content
- */
-int16_t renderer::shift_content(const int16_t shift_x) {
-  return shift_content(m_currentx, shift_x);
+  // Grow the spans until every primitive is either fully inside or
+  // outside of them, so redrawing never paints over clean pixels
+  for (bool grown = true; grown;) {
+    grown = false;
+    for (auto&& p : m_frame.primitives) {
+      int x1{p.x}, x2{p.x + p.w};
+      if (damaged(x1, x2) && !std::any_of(m_damage.begin(), m_damage.end(),
+                                 [&](const pair<int, int>& d) { return d.first <= x1 && x2 <= d.second; })) {
+        damage(x1, x2);
+        grown = true;
+      }
+    }
+  }
 }
 
-#ifdef DEBUG_HINTS
 /**
- * Draw boxes at the location of each created action block
+ * Add span to the sorted list of damaged areas
  */
-void renderer::debug_hints() {
-  uint16_t border_width{1};
-  map<alignment, int> hint_num{{
-      // clang-format off
-      {alignment::LEFT, 0},
-      {alignment::CENTER, 0},
-      {alignment::RIGHT, 0},
-      // clang-format on
-  }};
-
-  m_debughints.clear();
+void renderer::damage(int x1, int x2) {
+  x1 = std::max(x1, 0);
+  x2 = std::min(x2, static_cast<int>(m_rect.width));
 
-  for (auto&& action : m_actions) {
-    if (action.active) {
-      continue;
-    }
+  if (x1 >= x2) {
+    return;
+  }
 
-    xcb_window_t hintwin{m_connection.generate_id()};
-    m_debughints.emplace_back(hintwin);
+  auto it = std::lower_bound(m_damage.begin(), m_damage.end(), make_pair(x1, x2));
 
-    uint8_t num{static_cast<uint8_t>(hint_num.find(action.align)->second++)};
+  // Merge with the neighbouring spans that touch the new one
+  if (it != m_damage.begin() && std::prev(it)->second >= x1) {
+    --it;
+    x1 = it->first;
+  } else {
+    it = m_damage.emplace(it, x1, x2);
+  }
 
-    // clang-format off
-    winspec(m_connection, hintwin)
-      << cw_size(action.width() - border_width * 2, m_rect.height - border_width * 2)
-      << cw_pos(action.start_x + num * DEBUG_HINTS_OFFSET_X, m_bar.pos.y + m_rect.y + num * DEBUG_HINTS_OFFSET_Y)
-      << cw_border(border_width)
-      << cw_depth(m_depth)
-      << cw_visual(m_visual->visual_id)
-      << cw_params_colormap(m_colormap)
-      << cw_params_back_pixel(0)
-      << cw_params_border_pixel(num % 2 ? 0xFFFF0000 : 0xFF00FF00)
-      << cw_params_override_redirect(true)
-      << cw_flush()
-      ;
-    // clang-format on
+  it->second = std::max(it->second, x2);
 
-    xutils::compton_shadow_exclude(m_connection, hintwin);
-    m_connection.map_window(hintwin);
+  auto next = std::next(it);
+  while (next != m_damage.end() && next->first <= it->second) {
+    it->second = std::max(it->second, next->second);
+    next = m_damage.erase(next);
   }
 }
-#endif
 
-bool renderer::on(const change_background& evt) {
-  const uint32_t color{*evt()};
+/**
+ * Check if given span intersects a damaged area
+ */
+bool renderer::damaged(int x1, int x2) const {
+  return std::any_of(
+      m_damage.begin(), m_damage.end(), [&](const pair<int, int>& d) { return x1 < d.second && d.first < x2; });
+}
 
-  if (m_colors[gc::BG] == color) {
-    m_log.trace_x("renderer: ignoring unchanged background color(#%08x)", color);
-  } else {
-    m_log.trace_x("renderer: set_background(#%08x)", color);
-    m_connection.change_gc(m_gcontexts.at(gc::BG), XCB_GC_FOREGROUND, &color);
-    m_colors[gc::BG] = color;
-    shift_content(0);
+/**
+ * Clear the damaged areas and redraw the primitives inside of them
+ */
+void renderer::paint() {
+  if (m_damage.empty()) {
+    return m_log.trace_x("renderer: nothing to paint");
+  } else if (m_surface && paint_surface()) {
+    return;
   }
 
-  return true;
-}
-
-bool renderer::on(const change_foreground& evt) {
-  const uint32_t color{*evt()};
+  m_surfacevalid = false;
 
-  if (m_colors[gc::FG] == color) {
-    m_log.trace_x("renderer: ignoring unchanged foreground color(#%08x)", color);
-  } else {
-    m_log.trace_x("renderer: set_foreground(#%08x)", color);
-    m_connection.change_gc(m_gcontexts.at(gc::FG), XCB_GC_FOREGROUND, &color);
-    m_fontmanager->allocate_color(color);
-    m_colors[gc::FG] = color;
+  for (auto&& area : m_damage) {
+    use_color(gc::BG, m_bar.background);
+    draw_util::fill(m_connection, m_pixmap, m_gcontexts.at(gc::BG), area.first, 0, area.second - area.first,
+        m_rect.height);
   }
 
-  return true;
-}
+  for (auto&& p : m_frame.primitives) {
+    if (!damaged(p.x, p.x + p.w)) {
+      continue;
+    }
 
-bool renderer::on(const change_underline& evt) {
-  const uint32_t color{*evt()};
+    use_color(p.context, p.color);
 
-  if (m_colors[gc::UL] == color) {
-    m_log.trace_x("renderer: ignoring unchanged underline color(#%08x)", color);
-  } else {
-    m_log.trace_x("renderer: set_underline(#%08x)", color);
-    m_connection.change_gc(m_gcontexts.at(gc::UL), XCB_GC_FOREGROUND, &color);
-    m_colors[gc::UL] = color;
-  }
+    if (!p.font) {
+      draw_util::fill(m_connection, m_pixmap, m_gcontexts.at(p.context), p.x, p.y, p.w, p.h);
+      continue;
+    }
 
-  return true;
+    if (p.font->ptr != XCB_NONE && m_gcfont != p.font->ptr) {
+      const uint32_t v[1]{p.font->ptr};
+      m_connection.change_gc(m_gcontexts.at(gc::FG), XCB_GC_FONT, v);
+      m_gcfont = p.font->ptr;
+    }
+
+    m_fontmanager->drawtext(
+        p.font, m_pixmap, m_gcontexts.at(gc::FG), p.x, p.y, m_frame.chars.data() + p.text, p.length);
+  }
 }
 
-bool renderer::on(const change_overline& evt) {
-  const uint32_t color{*evt()};
+/**
+ * Compose the damaged areas in the client side surface and upload them
+ * to the pixmap in one request. Returns false when the frame contains
+ * glyphs that can only be drawn by the server, e.g. from core fonts
+ */
+bool renderer::paint_surface() {
+  if (m_surface->width() != m_rect.width || m_surface->height() != m_rect.height) {
+    m_surface->resize(m_rect.width, m_rect.height);
+    m_surfacevalid = false;
+  }
 
-  if (m_colors[gc::OL] == color) {
-    m_log.trace_x("renderer: ignoring unchanged overline color(#%08x)", color);
-  } else {
-    m_log.trace_x("renderer: set_overline(#%08x)", color);
-    m_connection.change_gc(m_gcontexts.at(gc::OL), XCB_GC_FOREGROUND, &color);
-    m_colors[gc::OL] = color;
+  // The surface does not contain frames drawn by the server
+  if (!m_surfacevalid) {
+    m_damage.clear();
+    m_damage.emplace_back(0, m_rect.width);
   }
 
-  return true;
-}
+  for (auto&& area : m_damage) {
+    m_surface->fill(area.first, 0, area.second - area.first, m_rect.height, m_bar.background);
+  }
 
-bool renderer::on(const change_font& evt) {
-  const uint8_t font{*evt()};
+  for (auto&& p : m_frame.primitives) {
+    if (!damaged(p.x, p.x + p.w)) {
+      continue;
+    } else if (!p.font) {
+      m_surface->fill(p.x, p.y, p.w, p.h, p.color);
+      continue;
+    }
 
-  if (m_fontindex == font) {
-    m_log.trace_x("renderer: ignoring unchanged font index(%i)", static_cast<uint8_t>(font));
-  } else {
-    m_log.trace_x("renderer: fontindex(%i)", static_cast<uint8_t>(font));
-    m_fontmanager->fontindex(font);
-    m_fontindex = font;
-  }
+    const text_run& run{m_fontmanager->measure(p.font, m_frame.chars.data() + p.text, p.length)};
+    int16_t x{p.x};
 
-  return true;
-}
+    for (size_t i = 0; i < run.glyphs.size(); i++) {
+      const glyph_bitmap* bitmap{m_fontmanager->rasterize(p.font, run.glyphs[i])};
 
-bool renderer::on(const change_alignment& evt) {
-  auto align = static_cast<const alignment&>(*evt());
+      if (bitmap == nullptr) {
+        m_log.trace_x("renderer: glyph cannot be drawn client side");
+        return false;
+      }
 
-  if (align == m_alignment) {
-    m_log.trace_x("renderer: ignoring unchanged alignment(%i)", static_cast<uint8_t>(align));
-  } else {
-    m_log.trace_x("renderer: set_alignment(%i)", static_cast<uint8_t>(align));
-    m_alignment = align;
-    m_currentx = 0;
+      m_surface->blend(x + bitmap->left, p.y - bitmap->top, bitmap->coverage.data(), bitmap->width, bitmap->rows,
+          p.color);
+      x += run.advances[i];
+    }
   }
 
-  return true;
-}
+  int x1{m_damage.front().first};
+  int x2{m_damage.back().second};
+  m_surface->upload(m_pixmap, m_gcontexts.at(gc::FG), x1, x2 - x1);
+  m_surfacevalid = true;
 
-bool renderer::on(const offset_pixel& evt) {
-  shift_content(*evt());
   return true;
 }
 
-bool renderer::on(const attribute_set& evt) {
-  m_log.trace_x("renderer: attribute_set(%i, %i)", static_cast<uint8_t>(*evt()), true);
-  m_attributes |= 1U << static_cast<uint8_t>(*evt());
-  return true;
+/**
+ * Record filled rectangle using the current color of given context
+ */
+void renderer::record_fill(gc context, int16_t x, int16_t y, uint16_t w, uint16_t h) {
+  m_frame.primitives.emplace_back(primitive{context, x, y, w, h, m_colors[context], nullptr, 0U, 0U});
 }
 
-bool renderer::on(const attribute_unset& evt) {
-  m_log.trace_x("renderer: attribute_unset(%i, %i)", static_cast<uint8_t>(*evt()), true);
-  m_attributes &= ~(1U << static_cast<uint8_t>(*evt()));
-  return true;
+/**
+ * Record text drawn with the current foreground color
+ */
+void renderer::record_text(
+    const shared_ptr<font_ref>& font, int16_t x, int16_t y, uint16_t w, const uint32_t* chars, size_t len) {
+  m_frame.primitives.emplace_back(primitive{gc::FG, x, y, w, 0U, m_colors[gc::FG], font, m_frame.chars.size(), len});
+  m_frame.chars.insert(m_frame.chars.end(), chars, chars + len);
 }
 
-bool renderer::on(const attribute_toggle& evt) {
-  m_log.trace_x("renderer: attribute_toggle(%i)", static_cast<uint8_t>(*evt()));
-  m_attributes ^= 1U << static_cast<uint8_t>(*evt());
-  return true;
+/**
+ * Update the color of given graphic context
+ */
+void renderer::use_color(gc context, uint32_t color) {
+  if (m_gccolors[context] == color) {
+    return;
+  }
+
+  m_connection.change_gc(m_gcontexts.at(context), XCB_GC_FOREGROUND, &color);
+  m_gccolors[context] = color;
+
+  if (context == gc::FG) {
+    m_fontmanager->allocate_color(color);
+  }
 }
 
-bool renderer::on(const action_begin& evt) {
-  auto a = static_cast<const action&>(*evt());
+/**
+ * Open clickable area at the current position
+ */
+void renderer::begin_action(const mousebtn btn, const string& cmd) {
   action_block action{};
-  action.button = a.button;
+  action.button = btn;
   action.align = m_alignment;
-  action.start_x = m_currentx;
-  action.command = string_util::replace_all(a.command, ":", "\\:");
+  action.start_x = m_rect.x + m_currentx;
+  action.command = string_util::replace_all(cmd, ":", "\\:");
   action.active = true;
 
   if (action.button == mousebtn::NONE) {
     action.button = mousebtn::LEFT;
   }
 
-  m_log.trace_x("renderer: action_begin(%i, %s)", static_cast<uint8_t>(a.button), a.command.c_str());
+  m_log.trace_x("renderer: action_begin(%i, %s)", static_cast<uint8_t>(btn), cmd.c_str());
+  m_openactions.emplace_back(m_actions.size());
   m_actions.emplace_back(action);
-
-  return true;
 }
 
-bool renderer::on(const action_end& evt) {
-  auto btn = static_cast<const mousebtn&>(*evt());
-  int16_t clickable_width{0};
+/**
+ * Close the open clickable area for given button
+ */
+void renderer::end_action(const mousebtn btn) {
+  for (auto it = m_openactions.rbegin(); it != m_openactions.rend();) {
+    auto& action = m_actions[*it];
 
-  for (auto action = m_actions.rbegin(); action != m_actions.rend(); action++) {
-    if (!action->active || action->align != m_alignment || action->button != btn) {
+    if (action.align != m_alignment || action.button != btn) {
+      ++it;
       continue;
     }
 
-    action->active = false;
-
-    switch (action->align) {
-      case alignment::NONE:
-        break;
-      case alignment::LEFT:
-        action->end_x = m_currentx;
-        break;
-      case alignment::CENTER:
-        clickable_width = m_currentx - action->start_x;
-        action->start_x = m_rect.width / 2 - clickable_width / 2 + action->start_x / 2;
-        action->end_x = action->start_x + clickable_width;
-        break;
-      case alignment::RIGHT:
-        action->start_x = m_rect.width - m_currentx + action->start_x;
-        action->end_x = m_rect.width;
-        break;
-    }
+    action.active = false;
+    action.end_x = m_rect.x + m_currentx;
 
-    action->start_x += m_rect.x;
-    action->end_x += m_rect.x;
+    m_log.trace_x("renderer: action_end(%i, %s, %i)", static_cast<uint8_t>(btn), action.command, action.width());
 
-    m_log.trace_x("renderer: action_end(%i, %s, %i)", static_cast<uint8_t>(btn), action->command, action->width());
+    it = decltype(it){m_openactions.erase(std::next(it).base())};
   }
-
-  return true;
 }
 
-bool renderer::on(const write_text_ascii& evt) {
-  const uint16_t data[1]{*evt()};
-  draw_textstring(data, 1);
-  return true;
+/**
+ * Get the clickable areas of the last completed frame
+ */
+shared_ptr<const action_index> renderer::actions() const {
+  return std::atomic_load(&m_actionindex);
 }
 
-bool renderer::on(const write_text_unicode& evt) {
-  const uint16_t data[1]{*evt()};
-  draw_textstring(data, 1);
-  return true;
-}
+#ifdef DEBUG_HINTS
+/**
+ * Draw boxes at the location of each created action block
+ */
+void renderer::debug_hints() {
+  uint16_t border_width{1};
+  map<alignment, int> hint_num{{
+      // clang-format off
+      {alignment::LEFT, 0},
+      {alignment::CENTER, 0},
+      {alignment::RIGHT, 0},
+      // clang-format on
+  }};
 
-bool renderer::on(const write_text_string& evt) {
-  auto pkt = static_cast<const parser::packet&>(*evt());
-  draw_textstring(pkt.data, pkt.length);
-  return true;
+  m_debughints.clear();
+
+  for (auto&& action : m_actions) {
+    if (action.active) {
+      continue;
+    }
+
+    xcb_window_t hintwin{m_connection.generate_id()};
+    m_debughints.emplace_back(hintwin);
+
+    uint8_t num{static_cast<uint8_t>(hint_num.find(action.align)->second++)};
+
+    // clang-format off
+    winspec(m_connection, hintwin)
+      << cw_size(action.width() - border_width * 2, m_rect.height - border_width * 2)
+      << cw_pos(action.start_x + num * DEBUG_HINTS_OFFSET_X, m_bar.pos.y + m_rect.y + num * DEBUG_HINTS_OFFSET_Y)
+      << cw_border(border_width)
+      << cw_depth(m_depth)
+      << cw_visual(m_visual->visual_id)
+      << cw_params_colormap(m_colormap)
+      << cw_params_back_pixel(0)
+      << cw_params_border_pixel(num % 2 ? 0xFFFF0000 : 0xFF00FF00)
+      << cw_params_override_redirect(true)
+      << cw_flush()
+      ;
+    // clang-format on
+
+    xutils::compton_shadow_exclude(m_connection, hintwin);
+    m_connection.map_window(hintwin);
+  }
 }
+#endif
 
 POLYBAR_NS_END
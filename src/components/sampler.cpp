@@ -0,0 +1,282 @@
+#include <numeric>
+
+#include "components/sampler.hpp"
+#include "config.hpp"
+#include "utils/factory.hpp"
+
+POLYBAR_NS
+
+namespace {
+  /**
+   * Per core times from /proc/stat
+   */
+  void parse(procfs_scanner scanner, const cpu_sample* previous, cpu_sample& sample) {
+    if (previous != nullptr) {
+      for (auto&& field : sample.times) {
+        field.reserve(previous->cores);
+      }
+      sample.total.reserve(previous->cores);
+      sample.idle.reserve(previous->cores);
+    }
+
+    for (; scanner.match("cpu"); scanner.next_line()) {
+      // skip line with accumulated value
+      if (scanner.match("cpu ")) {
+        continue;
+      }
+
+      scanner.skip_word();
+
+      // fields missing on older kernels are left at zero
+      uint64_t values[CPU_FIELDS]{};
+      for (size_t i = 0; i < CPU_FIELDS; i++) {
+        long long value{0};
+        scanner.next(value);
+        values[i] = static_cast<uint64_t>(value);
+        sample.times[i].emplace_back(values[i]);
+      }
+
+      uint64_t idle{values[CPU_IDLE] + values[CPU_IOWAIT]};
+      uint64_t busy{values[CPU_USER] + values[CPU_NICE] + values[CPU_SYSTEM] + values[CPU_IRQ] +
+                    values[CPU_SOFTIRQ] + values[CPU_STEAL]};
+      sample.idle.emplace_back(idle);
+      sample.total.emplace_back(idle + busy);
+    }
+
+    sample.cores = sample.total.size();
+  }
+
+  void parse(procfs_scanner scanner, const memory_sample*, memory_sample& sample) {
+    long long value{0};
+    auto start = scanner;
+
+    if (scanner.seek("MemTotal:") && scanner.next(value)) {
+      sample.kb_total = value;
+    }
+    scanner = start;
+    if (scanner.seek("MemAvailable:") && scanner.next(value)) {
+      sample.kb_avail = value;
+    }
+  }
+
+  void parse(procfs_scanner scanner, const thermal_sample*, thermal_sample& sample) {
+    scanner.next(sample.millidegrees);
+  }
+
+  /**
+   * Traffic counters from /proc/net/dev, the first
+   * two lines hold the column headers
+   */
+  void parse(procfs_scanner scanner, const net_sample*, net_sample& sample) {
+    scanner.next_line();
+    scanner.next_line();
+
+    for (; !scanner.eof(); scanner.next_line()) {
+      net_device device{};
+      long long values[9]{0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+      if (!scanner.next(device.name, ':')) {
+        continue;
+      }
+      for (auto&& value : values) {
+        scanner.next(value);
+      }
+
+      device.received = values[0];
+      device.transmitted = values[8];
+      sample.devices.emplace_back(move(device));
+    }
+  }
+}
+
+// implementation of cpu_load {{{
+
+/**
+ * Compare the per core times of two samples, the load stays at
+ * zero without a previous sample or if the core count changed
+ */
+cpu_load::cpu_load(const cpu_sample* previous, const cpu_sample& current) : cores(current.cores, 0.0f) {
+  const size_t count{current.cores};
+
+  if (previous == nullptr || previous->cores != count || !count) {
+    return;
+  }
+
+  const uint64_t* total{current.total.data()};
+  const uint64_t* idle{current.idle.data()};
+  const uint64_t* prev_total{previous->total.data()};
+  const uint64_t* prev_idle{previous->idle.data()};
+  float* load{cores.data()};
+
+  // clamped in integer arithmetic so that the loop stays branch free
+  // and can be vectorized, the deltas between two samples fit in 32 bits
+  for (size_t i = 0; i < count; i++) {
+    auto diff = static_cast<int32_t>(total[i] - prev_total[i]);
+    auto busy = diff - static_cast<int32_t>(idle[i] - prev_idle[i]);
+    diff = diff > 1 ? diff : 1;
+    busy = busy > 0 ? busy : 0;
+    busy = busy < diff ? busy : diff;
+    load[i] = 100.0f * static_cast<float>(busy) / static_cast<float>(diff);
+  }
+
+  average = std::accumulate(load, load + count, 0.0f) / static_cast<float>(count);
+}
+
+// }}}
+// implementation of sampler::source {{{
+
+template <typename Snapshot>
+sampler::source<Snapshot>::source(string path) : m_file(move(path)) {}
+
+template <typename Snapshot>
+const string& sampler::source<Snapshot>::path() const {
+  return m_file.path();
+}
+
+template <typename Snapshot>
+typename sampler::source<Snapshot>::iterator sampler::source<Snapshot>::attach(duration interval) {
+  std::lock_guard<std::mutex> guard(m_lock);
+  return m_intervals.emplace(interval);
+}
+
+template <typename Snapshot>
+void sampler::source<Snapshot>::detach(iterator it) {
+  std::lock_guard<std::mutex> guard(m_lock);
+  m_intervals.erase(it);
+}
+
+/**
+ * Get the latest snapshot, reading the source again if the
+ * current one is older than half of the fastest interval
+ *
+ * Returns nullptr if the source could not be read
+ */
+template <typename Snapshot>
+shared_ptr<const Snapshot> sampler::source<Snapshot>::get() {
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  auto now = clock::now();
+
+  if (m_snapshot && !m_intervals.empty() && now - m_snapshot->time < *m_intervals.begin() / 2) {
+    return m_snapshot;
+  } else if (!m_file.read()) {
+    return nullptr;
+  }
+
+  auto snapshot = make_shared<Snapshot>();
+  snapshot->time = now;
+  parse(m_file.scan(), m_snapshot.get(), *snapshot);
+  m_snapshot = move(snapshot);
+
+  return m_snapshot;
+}
+
+// }}}
+// implementation of sampler::subscription {{{
+
+template <typename Snapshot>
+sampler::subscription<Snapshot>::subscription(shared_ptr<source<Snapshot>> src, duration interval)
+    : m_source(move(src)), m_interval(m_source->attach(interval)) {}
+
+template <typename Snapshot>
+sampler::subscription<Snapshot>::subscription(subscription&& other)
+    : m_source(move(other.m_source)), m_interval(other.m_interval) {}
+
+template <typename Snapshot>
+sampler::subscription<Snapshot>& sampler::subscription<Snapshot>::operator=(subscription&& other) {
+  if (this != &other) {
+    release();
+    m_source = move(other.m_source);
+    m_interval = other.m_interval;
+  }
+  return *this;
+}
+
+template <typename Snapshot>
+sampler::subscription<Snapshot>::~subscription() {
+  release();
+}
+
+template <typename Snapshot>
+sampler::subscription<Snapshot>::operator bool() const {
+  return static_cast<bool>(m_source);
+}
+
+template <typename Snapshot>
+const string& sampler::subscription<Snapshot>::path() const {
+  return m_source->path();
+}
+
+template <typename Snapshot>
+shared_ptr<const Snapshot> sampler::subscription<Snapshot>::get() const {
+  return m_source ? m_source->get() : nullptr;
+}
+
+template <typename Snapshot>
+void sampler::subscription<Snapshot>::release() {
+  if (m_source) {
+    m_source->detach(m_interval);
+    m_source.reset();
+  }
+}
+
+// }}}
+// implementation of sampler {{{
+
+/**
+ * Create instance
+ */
+sampler::make_type sampler::make() {
+  return static_cast<sampler&>(*factory_util::singleton<sampler>());
+}
+
+sampler::subscription<cpu_sample> sampler::cpu(duration interval) {
+  return subscribe<cpu_sample>(PATH_CPU_INFO, interval);
+}
+
+sampler::subscription<memory_sample> sampler::memory(duration interval) {
+  return subscribe<memory_sample>(PATH_MEMORY_INFO, interval);
+}
+
+sampler::subscription<thermal_sample> sampler::thermal(const string& path, duration interval) {
+  return subscribe<thermal_sample>(path, interval);
+}
+
+sampler::subscription<net_sample> sampler::net(duration interval) {
+  return subscribe<net_sample>("/proc/net/dev", interval);
+}
+
+/**
+ * Attach to the source for given path, opening
+ * it if there are no other subscribers
+ */
+template <typename Snapshot>
+sampler::subscription<Snapshot> sampler::subscribe(const string& path, duration interval) {
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  auto src = std::static_pointer_cast<source<Snapshot>>(m_sources[path].lock());
+
+  if (!src) {
+    src = make_shared<source<Snapshot>>(path);
+    m_sources[path] = src;
+  }
+
+  for (auto it = m_sources.begin(); it != m_sources.end();) {
+    it = it->second.expired() ? m_sources.erase(it) : std::next(it);
+  }
+
+  return subscription<Snapshot>{move(src), interval};
+}
+
+// }}}
+
+template class sampler::source<cpu_sample>;
+template class sampler::source<memory_sample>;
+template class sampler::source<thermal_sample>;
+template class sampler::source<net_sample>;
+template class sampler::subscription<cpu_sample>;
+template class sampler::subscription<memory_sample>;
+template class sampler::subscription<thermal_sample>;
+template class sampler::subscription<net_sample>;
+
+POLYBAR_NS_END
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+
+#include "components/logger.hpp"
+#include "components/scheduler.hpp"
+#include "events/signal.hpp"
+#include "events/signal_emitter.hpp"
+#include "utils/factory.hpp"
+
+POLYBAR_NS
+
+constexpr chrono::milliseconds scheduler::TICK;
+constexpr size_t scheduler::WORKERS;
+
+/**
+ * Create instance
+ */
+scheduler::make_type scheduler::make() {
+  return static_cast<scheduler&>(*factory_util::singleton<scheduler>(signal_emitter::make(), logger::make()));
+}
+
+/**
+ * Construct scheduler and start the dispatch and worker threads
+ */
+scheduler::scheduler(signal_emitter& emitter, const logger& logger) : m_sig(emitter), m_log(logger) {
+  for (size_t i = 0; i < WORKERS; i++) {
+    m_workers.emplace_back(&scheduler::worker, this);
+  }
+  m_thread = std::thread(&scheduler::runner, this);
+}
+
+/**
+ * Deconstruct scheduler
+ */
+scheduler::~scheduler() {
+  if (m_active && m_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_active = false;
+    }
+    m_hold.notify_all();
+    m_ready.notify_all();
+    m_thread.join();
+    for (auto&& worker : m_workers) {
+      worker.join();
+    }
+  }
+}
+
+/**
+ * Add periodic task
+ *
+ * The task runs on the next tick and from then on
+ * at every multiple of the given interval
+ */
+scheduler::handle scheduler::add(duration interval, callback fn) {
+  std::unique_lock<std::mutex> guard(m_lock);
+  auto ticks = static_cast<timer_wheel::tick_t>(std::llround(interval / TICK));
+  auto id = ++m_counter;
+  m_tasks.emplace(id, task{std::max<timer_wheel::tick_t>(ticks, 1), move(fn)});
+  m_wheel.insert(id, current_tick() + 1);
+  guard.unlock();
+  m_hold.notify_one();
+  return id;
+}
+
+/**
+ * Remove task
+ *
+ * Waits for the task to finish if it is currently running,
+ * unless called from within a task
+ */
+void scheduler::remove(handle task) {
+  std::unique_lock<std::mutex> guard(m_lock);
+  m_tasks.erase(task);
+  m_wheel.remove(task);
+  m_triggered.erase(task);
+  m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), task), m_queue.end());
+  if (!is_worker()) {
+    m_done.wait(guard, [&] { return m_running.find(task) == m_running.end(); });
+  }
+}
+
+/**
+ * Run task on the next tick
+ *
+ * A task that is queued or running is run again as soon as it returns
+ */
+void scheduler::trigger(handle task) {
+  std::unique_lock<std::mutex> guard(m_lock);
+  if (m_tasks.find(task) == m_tasks.end()) {
+    return;
+  } else if (m_running.find(task) != m_running.end() ||
+             std::find(m_queue.begin(), m_queue.end(), task) != m_queue.end()) {
+    m_triggered.emplace(task);
+  } else {
+    m_wheel.insert(task, current_tick() + 1);
+    guard.unlock();
+    m_hold.notify_one();
+  }
+}
+
+/**
+ * Dispatch loop, hands the expired tasks to the workers
+ */
+void scheduler::runner() {
+  m_log.info("Scheduler dispatcher (thread-id=%lu)", std::this_thread::get_id());
+
+  std::unique_lock<std::mutex> guard(m_lock);
+  vector<handle> expired;
+
+  while (m_active) {
+    expired.clear();
+    m_wheel.advance(current_tick(), expired);
+
+    if (expired.empty()) {
+      if (m_wheel.empty()) {
+        m_hold.wait(guard);
+      } else {
+        m_hold.wait_until(guard, tick_time(m_wheel.next_expiry()));
+      }
+      continue;
+    }
+
+    for (auto&& id : expired) {
+      if (m_tasks.find(id) == m_tasks.end()) {
+        continue;
+      } else if (m_running.find(id) != m_running.end() ||
+                 std::find(m_queue.begin(), m_queue.end(), id) != m_queue.end()) {
+        m_triggered.emplace(id);
+      } else {
+        m_queue.emplace_back(id);
+      }
+    }
+
+    m_ready.notify_all();
+  }
+}
+
+/**
+ * Worker loop, runs the queued tasks
+ */
+void scheduler::worker() {
+  m_log.trace("Scheduler worker (thread-id=%lu)", std::this_thread::get_id());
+
+  std::unique_lock<std::mutex> guard(m_lock);
+
+  while (true) {
+    m_ready.wait(guard, [&] { return !m_active || !m_queue.empty(); });
+
+    if (!m_active) {
+      break;
+    }
+
+    auto id = m_queue.front();
+    m_queue.pop_front();
+
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end()) {
+      continue;
+    }
+
+    callback fn{it->second.func};
+    m_running.emplace(id);
+    guard.unlock();
+    bool changed{fn()};
+    guard.lock();
+    m_running.erase(id);
+    m_done.notify_all();
+
+    reschedule(id);
+
+    // Tasks expiring in the same tick usually finish together,
+    // the last one of them to return emits for all of them
+    m_changed |= changed;
+
+    if (m_changed && m_queue.empty()) {
+      m_changed = false;
+      guard.unlock();
+      m_sig.emit(signals::eventqueue::notify_change{});
+      guard.lock();
+    }
+  }
+}
+
+/**
+ * Schedule the next run of a task that has returned at the following
+ * multiple of its interval, or on the next tick if it was triggered
+ * while it was running
+ */
+void scheduler::reschedule(handle id) {
+  auto it = m_tasks.find(id);
+
+  if (it == m_tasks.end() || m_wheel.contains(id)) {
+    return;
+  } else if (m_triggered.erase(id)) {
+    m_wheel.insert(id, current_tick() + 1);
+  } else {
+    auto interval = it->second.interval;
+    m_wheel.insert(id, (current_tick() / interval + 1) * interval);
+  }
+
+  m_hold.notify_one();
+}
+
+/**
+ * Test if the calling thread is one of the workers
+ */
+bool scheduler::is_worker() const {
+  auto id = std::this_thread::get_id();
+  return std::any_of(m_workers.begin(), m_workers.end(), [&](const std::thread& t) { return t.get_id() == id; });
+}
+
+/**
+ * Get the tick for the current time
+ */
+timer_wheel::tick_t scheduler::current_tick() const {
+  return static_cast<timer_wheel::tick_t>((clock::now() - m_epoch) / TICK);
+}
+
+/**
+ * Get the time at which given tick starts
+ */
+scheduler::clock::time_point scheduler::tick_time(timer_wheel::tick_t tick) const {
+  return m_epoch + chrono::duration_cast<clock::duration>(TICK * tick);
+}
+
+POLYBAR_NS_END
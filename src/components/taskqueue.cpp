@@ -14,22 +14,11 @@ taskqueue::taskqueue() {
     while (m_active) {
       std::unique_lock<std::mutex> guard(m_lock);
 
-      if (m_deferred.empty()) {
+      if (m_heap.empty()) {
         m_hold.wait(guard);
+      } else if (m_heap.front()->deadline > deferred::clock::now()) {
+        m_hold.wait_until(guard, m_heap.front()->deadline);
       } else {
-        auto now = deferred::clock::now();
-        auto wait = m_deferred.front()->now + m_deferred.front()->wait;
-        for (auto&& task : m_deferred) {
-          auto when = task->now + task->wait;
-          if (when < wait) {
-            wait = move(when);
-          }
-        }
-        if (wait > now) {
-          m_hold.wait_for(guard, wait - now);
-        }
-      }
-      if (!m_deferred.empty()) {
         guard.unlock();
         tick();
       }
@@ -48,40 +37,34 @@ taskqueue::~taskqueue() {
 void taskqueue::defer(
     string id, deferred::duration ms, deferred::callback fn, deferred::duration offset, size_t count) {
   std::unique_lock<std::mutex> guard(m_lock);
-  deferred::timepoint now{chrono::time_point_cast<deferred::duration>(deferred::clock::now() + move(offset))};
-  m_deferred.emplace_back(make_unique<deferred>(move(id), move(now), move(ms), move(fn), move(count)));
+  push(move(id), move(ms), move(fn), move(offset), move(count));
   guard.unlock();
   m_hold.notify_one();
 }
 
 void taskqueue::defer_unique(
     string id, deferred::duration ms, deferred::callback fn, deferred::duration offset, size_t count) {
-  purge(id);
   std::unique_lock<std::mutex> guard(m_lock);
-  deferred::timepoint now{chrono::time_point_cast<deferred::duration>(deferred::clock::now() + move(offset))};
-  m_deferred.emplace_back(make_unique<deferred>(move(id), move(now), move(ms), move(fn), move(count)));
+  erase(id);
+  push(move(id), move(ms), move(fn), move(offset), move(count));
   guard.unlock();
   m_hold.notify_one();
 }
 
 void taskqueue::tick() {
-  if (!m_lock.try_lock()) {
-    return;
-  }
-  std::unique_lock<std::mutex> guard(m_lock, std::adopt_lock);
+  std::unique_lock<std::mutex> guard(m_lock);
   auto now = chrono::time_point_cast<deferred::duration>(deferred::clock::now());
   vector<pair<deferred::callback, size_t>> cbs;
-  for (auto it = m_deferred.rbegin(); it != m_deferred.rend(); ++it) {
-    auto& task = *it;
-    if (task->now + task->wait > now) {
-      continue;
-    } else if (task->count--) {
-      cbs.emplace_back(make_pair(task->func, task->count));
-      task->now = now;
+  while (!m_heap.empty() && m_heap.front()->deadline <= now) {
+    auto task = m_heap.front();
+    if (task->count) {
+      cbs.emplace_back(make_pair(task->func, --task->count));
+    }
+    if (task->count) {
+      task->deadline = now + task->wait;
+      sift_down(0);
     } else {
-      m_deferred.erase(std::remove_if(m_deferred.begin(), m_deferred.end(),
-                           [&](const unique_ptr<deferred>& d) { return d == task; }),
-          m_deferred.end());
+      erase(task);
     }
   }
   guard.unlock();
@@ -92,19 +75,102 @@ void taskqueue::tick() {
 
 bool taskqueue::purge(const string& id) {
   std::lock_guard<std::mutex> guard(m_lock);
-  return m_deferred.erase(std::remove_if(m_deferred.begin(), m_deferred.end(),
-                              [id](const unique_ptr<deferred>& d) { return d->id == id; }),
-             m_deferred.end()) == m_deferred.end();
+  return erase(id);
 }
 
 bool taskqueue::exist(const string& id) {
   std::lock_guard<std::mutex> guard(m_lock);
-  for (const auto& task : m_deferred) {
-    if (task->id == id) {
-      return true;
+  return m_tasks.find(id) != m_tasks.end();
+}
+
+/**
+ * Add task to the heap, expects the lock to be held
+ */
+void taskqueue::push(
+    string&& id, deferred::duration ms, deferred::callback&& fn, deferred::duration offset, size_t count) {
+  auto deadline = chrono::time_point_cast<deferred::duration>(deferred::clock::now() + offset + ms);
+  auto task = make_unique<deferred>(id, deadline, ms, move(fn), count);
+  task->index = m_heap.size();
+  m_heap.emplace_back(task.get());
+  m_tasks.emplace(move(id), move(task));
+  sift_up(m_heap.size() - 1);
+}
+
+/**
+ * Remove all tasks with given id, expects the lock to be held
+ */
+bool taskqueue::erase(const string& id) {
+  auto range = m_tasks.equal_range(id);
+  if (range.first == range.second) {
+    return false;
+  }
+  for (auto it = range.first; it != range.second; ++it) {
+    auto index = it->second->index;
+    swap(index, m_heap.size() - 1);
+    m_heap.pop_back();
+    if (index < m_heap.size()) {
+      sift_up(index);
+      sift_down(index);
+    }
+  }
+  m_tasks.erase(range.first, range.second);
+  return true;
+}
+
+/**
+ * Remove single task, expects the lock to be held
+ */
+void taskqueue::erase(deferred* task) {
+  auto index = task->index;
+  swap(index, m_heap.size() - 1);
+  m_heap.pop_back();
+  if (index < m_heap.size()) {
+    sift_up(index);
+    sift_down(index);
+  }
+  auto range = m_tasks.equal_range(task->id);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.get() == task) {
+      m_tasks.erase(it);
+      break;
     }
   }
-  return false;
+}
+
+void taskqueue::sift_up(size_t index) {
+  while (index > 0) {
+    auto parent = (index - 1) / 2;
+    if (m_heap[parent]->deadline <= m_heap[index]->deadline) {
+      break;
+    }
+    swap(index, parent);
+    index = parent;
+  }
+}
+
+void taskqueue::sift_down(size_t index) {
+  while (true) {
+    auto smallest = index;
+    auto left = 2 * index + 1;
+    auto right = left + 1;
+    if (left < m_heap.size() && m_heap[left]->deadline < m_heap[smallest]->deadline) {
+      smallest = left;
+    }
+    if (right < m_heap.size() && m_heap[right]->deadline < m_heap[smallest]->deadline) {
+      smallest = right;
+    }
+    if (smallest == index) {
+      break;
+    }
+    swap(index, smallest);
+    index = smallest;
+  }
+}
+
+void taskqueue::swap(size_t a, size_t b) {
+  std::swap(m_heap[a], m_heap[b]);
+  m_heap[a]->index = a;
+  m_heap[b]->index = b;
 }
 
 POLYBAR_NS_END
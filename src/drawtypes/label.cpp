@@ -6,12 +6,27 @@
 POLYBAR_NS
 
 namespace drawtypes {
+  /**
+   * Get the label text with the current token values,
+   * rendered in one pass into a reused buffer
+   */
   string label::get() const {
+    if (m_dirty) {
+      m_tokenized.clear();
+      for (auto&& seg : m_segments) {
+        if (seg.slot == -1) {
+          m_tokenized.append(m_text, seg.offset, seg.length);
+        } else {
+          m_tokenized.append(m_slots[seg.slot].value);
+        }
+      }
+      m_dirty = false;
+    }
     return m_tokenized;
   }
 
   label::operator bool() {
-    return !m_tokenized.empty();
+    return !get().empty();
   }
 
   label_t label::clone() {
@@ -25,28 +40,52 @@ namespace drawtypes {
   }
 
   void label::reset_tokens() {
-    m_tokenized = m_text;
+    for (auto&& s : m_slots) {
+      s.value.assign(m_tokens[s.rules].token);
+    }
+    m_dirty = true;
   }
 
-  bool label::has_token(const string& token) {
-    return m_text.find(token) != string::npos;
+  bool label::has_token(const string& token) const {
+    return slot(token) != -1;
+  }
+
+  /**
+   * Get the slot used for given token, or -1 if the
+   * label doesn't contain the token
+   */
+  int label::slot(const string& token) const {
+    for (size_t i = 0; i < m_slots.size(); i++) {
+      if (m_tokens[m_slots[i].rules].token == token) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
   }
 
   void label::replace_token(const string& token, string replacement) {
-    if (!has_token(token)) {
+    replace_token(slot(token), move(replacement));
+  }
+
+  /**
+   * Set the value of a token slot, applying its min/max rules
+   */
+  void label::replace_token(int slot, string replacement) {
+    if (slot == -1) {
       return;
     }
 
-    for (auto&& tok : m_tokens) {
-      if (token == tok.token) {
-        if (tok.max != 0_z && replacement.length() > tok.max) {
-          replacement = replacement.erase(tok.max) + tok.suffix;
-        } else if (tok.min != 0_z && replacement.length() < tok.min) {
-          replacement.insert(0_z, tok.min - replacement.length(), ' ');
-        }
-        m_tokenized = string_util::replace_all(m_tokenized, token, move(replacement));
-      }
+    auto& s = m_slots[slot];
+    const auto& tok = m_tokens[s.rules];
+
+    if (tok.max != 0_z && replacement.length() > tok.max) {
+      replacement = replacement.erase(tok.max) + tok.suffix;
+    } else if (tok.min != 0_z && replacement.length() < tok.min) {
+      replacement.insert(0_z, tok.min - replacement.length(), ' ');
     }
+
+    s.value = move(replacement);
+    m_dirty = true;
   }
 
   void label::replace_defined_values(const label_t& label) {
@@ -118,40 +157,54 @@ namespace drawtypes {
   }
 
   /**
-   * Create a label by loading values from the configuration
+   * Split the text into literal segments and token slots
    */
-  label_t load_label(const config& conf, const string& section, string name, bool required, string def) {
-    vector<token> tokens;
-    size_t start, end, pos;
-
-    name = string_util::ltrim(string_util::rtrim(move(name), '>'), '<');
+  void label::compile() {
+    for (size_t i = 0; i < m_tokens.size(); i++) {
+      if (slot(m_tokens[i].token) == -1) {
+        m_slots.emplace_back(slot_value{i, m_tokens[i].token});
+      }
+    }
 
-    string text;
+    size_t literal{0_z};
+    size_t pos{0_z};
 
-    struct side_values padding {
-    }, margin{};
+    while (!m_slots.empty() && (pos = m_text.find('%', pos)) != string::npos) {
+      int match{-1};
 
-    if (required) {
-      text = conf.get(section, name);
-    } else {
-      text = conf.get(section, name, move(def));
-    }
+      for (size_t i = 0; i < m_slots.size(); i++) {
+        const auto& tok = m_tokens[m_slots[i].rules].token;
+        if (m_text.compare(pos, tok.size(), tok) == 0) {
+          match = static_cast<int>(i);
+          break;
+        }
+      }
 
-    size_t len{text.size()};
+      if (match == -1) {
+        pos++;
+        continue;
+      }
 
-    if (len > 2 && text[0] == '"' && text[len - 1] == '"') {
-      text = text.substr(1, len - 2);
+      if (pos > literal) {
+        m_segments.emplace_back(segment{literal, pos - literal, -1});
+      }
+      m_segments.emplace_back(segment{0_z, 0_z, match});
+      pos += m_tokens[m_slots[match].rules].token.size();
+      literal = pos;
     }
 
-    const auto get_left_right = [&](string key) {
-      auto value = conf.get(section, key, 0U);
-      auto left = conf.get(section, key + "-left", value);
-      auto right = conf.get(section, key + "-right", value);
-      return side_values{static_cast<uint16_t>(left), static_cast<uint16_t>(right)};
-    };
+    if (literal < m_text.size()) {
+      m_segments.emplace_back(segment{literal, m_text.size() - literal, -1});
+    }
+  }
 
-    padding = get_left_right(name + "-padding");
-    margin = get_left_right(name + "-margin");
+  /**
+   * Extract the tokens from the label text, the min/max
+   * specifiers are stripped from the tokens in the text
+   */
+  vector<token> tokenize(string& text) {
+    vector<token> tokens;
+    size_t start, end, pos;
 
     string line{text};
 
@@ -201,10 +254,48 @@ namespace drawtypes {
 
       // find suffix delimiter
       if ((pos = token_str.find(':', pos + 1)) != string::npos) {
-        token.suffix = token_str.substr(pos + 1, end - pos - 1);
+        token.suffix = token_str.substr(pos + 1, token_str.size() - pos - 2);
       }
     }
 
+    return tokens;
+  }
+
+  /**
+   * Create a label by loading values from the configuration
+   */
+  label_t load_label(const config& conf, const string& section, string name, bool required, string def) {
+    name = string_util::ltrim(string_util::rtrim(move(name), '>'), '<');
+
+    string text;
+
+    struct side_values padding {
+    }, margin{};
+
+    if (required) {
+      text = conf.get(section, name);
+    } else {
+      text = conf.get(section, name, move(def));
+    }
+
+    size_t len{text.size()};
+
+    if (len > 2 && text[0] == '"' && text[len - 1] == '"') {
+      text = text.substr(1, len - 2);
+    }
+
+    const auto get_left_right = [&](string key) {
+      auto value = conf.get(section, key, 0U);
+      auto left = conf.get(section, key + "-left", value);
+      auto right = conf.get(section, key + "-right", value);
+      return side_values{static_cast<uint16_t>(left), static_cast<uint16_t>(right)};
+    };
+
+    padding = get_left_right(name + "-padding");
+    margin = get_left_right(name + "-margin");
+
+    auto tokens = tokenize(text);
+
     // clang-format off
     return factory_util::shared<label>(text,
         conf.get(section, name + "-foreground", ""s),
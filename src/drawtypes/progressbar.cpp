@@ -13,14 +13,17 @@ namespace drawtypes {
       : m_builder(factory_util::unique<builder>(bar)), m_format(move(format)), m_width(width) {}
 
   void progressbar::set_fill(icon_t&& fill) {
+    m_cached.clear();
     m_fill = forward<decltype(fill)>(fill);
   }
 
   void progressbar::set_empty(icon_t&& empty) {
+    m_cached.clear();
     m_empty = forward<decltype(empty)>(empty);
   }
 
   void progressbar::set_indicator(icon_t&& indicator) {
+    m_cached.clear();
     if (!m_indicator && indicator.get()) {
       m_width--;
     }
@@ -28,10 +31,12 @@ namespace drawtypes {
   }
 
   void progressbar::set_gradient(bool mode) {
+    m_cached.clear();
     m_gradient = mode;
   }
 
   void progressbar::set_colors(vector<string>&& colors) {
+    m_cached.clear();
     m_colors = forward<decltype(colors)>(colors);
 
     if (m_colors.empty()) {
@@ -42,11 +47,35 @@ namespace drawtypes {
   }
 
   string progressbar::output(float percentage) {
-    string output{m_format};
-
     // Get fill/empty widths based on percentage
     unsigned int perc = math_util::cap(percentage, 0.0f, 100.0f);
     unsigned int fill_width = math_util::percentage_to_value(perc, m_width);
+
+    // Solid colored bars also change color with the percentage
+    size_t levels{1};
+    size_t level{0};
+    if (!m_colors.empty() && !m_gradient) {
+      levels = m_colors.size();
+      level = math_util::percentage_to_value<size_t>(perc, m_colors.size() - 1);
+    }
+
+    if (m_cached.empty()) {
+      m_cache.assign((m_width + 1) * levels, "");
+      m_cached.assign(m_cache.size(), false);
+    }
+
+    size_t index{fill_width * levels + level};
+
+    if (!m_cached[index]) {
+      m_cache[index] = render(perc, fill_width);
+      m_cached[index] = true;
+    }
+
+    return m_cache[index];
+  }
+
+  string progressbar::render(unsigned int perc, unsigned int fill_width) {
+    string output{m_format};
     unsigned int empty_width = m_width - fill_width;
 
     // Output fill icons
@@ -16,11 +16,13 @@ namespace modules {
     if (!file_util::exists(path)) {
       throw module_error("The file '" + path + "' does not exist");
     }
-    m_path = path;
+    m_file = make_unique<procfs_file>(path);
   }
 
   float backlight_module::brightness_handle::read() const {
-    return std::strtof(file_util::contents(m_path).c_str(), nullptr);
+    float value{0.0f};
+    m_file->read(value);
+    return value;
   }
 
   backlight_module::backlight_module(const bar_settings& bar, string name_)
@@ -67,15 +69,19 @@ namespace modules {
     return true;
   }
 
-  bool backlight_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_BAR) {
-      builder->node(m_progressbar->output(m_percentage));
-    } else if (tag == TAG_RAMP) {
-      builder->node(m_ramp->get_by_percentage(m_percentage));
-    } else if (tag == TAG_LABEL) {
-      builder->node(m_label);
-    } else {
-      return false;
+  bool backlight_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_BAR):
+        builder->node(m_progressbar->output(m_percentage));
+        break;
+      case tag_id(TAG_RAMP):
+        builder->node(m_ramp->get_by_percentage(m_percentage));
+        break;
+      case tag_id(TAG_LABEL):
+        builder->node(m_label);
+        break;
+      default:
+        return false;
     }
     return true;
   }
@@ -3,8 +3,6 @@
 #include "drawtypes/label.hpp"
 #include "drawtypes/progressbar.hpp"
 #include "drawtypes/ramp.hpp"
-#include "utils/file.hpp"
-#include "utils/math.hpp"
 
 #include "modules/meta/base.inl"
 
@@ -13,72 +11,32 @@ POLYBAR_NS
 namespace modules {
   template class module<battery_module>;
 
-  template <typename ValueReader>
-  typename ValueReader::return_type read(ValueReader& reader) {
-    std::lock_guard<ValueReader> guard(reader);
-    return reader.read();
-  }
-
   /**
    * Bootstrap module by setting up required components
    */
   battery_module::battery_module(const bar_settings& bar, string name_)
-      : inotify_module<battery_module>(bar, move(name_)) {
+      : event_module<battery_module>(bar, move(name_)) {
     // Load configuration values
     m_fullat = m_conf.get(name(), "full-at", m_fullat);
     m_interval = m_conf.get<decltype(m_interval)>(name(), "poll-interval", 5s);
-    m_lastpoll = chrono::system_clock::now();
 
-    auto path_adapter = string_util::replace(PATH_ADAPTER, "%adapter%", m_conf.get(name(), "adapter", "ADP1"s)) + "/";
-    auto path_battery = string_util::replace(PATH_BATTERY, "%battery%", m_conf.get(name(), "battery", "BAT0"s)) + "/";
+    auto path_adapter = string_util::replace(PATH_ADAPTER, "%adapter%", m_conf.get(name(), "adapter", "ADP1"s));
+    auto path_battery = string_util::replace(PATH_BATTERY, "%battery%", m_conf.get(name(), "battery", "BAT0"s));
 
-    // Make state reader
-    if (file_util::exists((m_fstate = path_adapter + "online"))) {
-      m_state_reader = make_unique<state_reader>([=] { return file_util::contents(m_fstate).erase(1) == "1"; });
-    } else if (file_util::exists((m_fstate = path_battery + "status"))) {
-      m_state_reader = make_unique<state_reader>([=] { return file_util::contents(m_fstate).erase(8) == "Charging"; });
-    } else {
-      throw module_error("No suitable way to get current charge state");
+    try {
+      m_battery = make_unique<power_supply::battery>(path_battery, path_adapter);
+    } catch (const power_supply::power_supply_error& err) {
+      throw module_error(err.what());
     }
 
-    // Make capacity reader
-    if ((m_fcapnow = file_util::pick({path_battery + "charge_now", path_battery + "energy_now"})).empty()) {
-      throw module_error("No suitable way to get current capacity value");
-    } else if ((m_fcapfull = file_util::pick({path_battery + "charge_full", path_battery + "energy_full"})).empty()) {
-      throw module_error("No suitable way to get max capacity value");
+    // Listen for power supply changes, fall back to polling the
+    // values if the kernel events aren't available
+    try {
+      m_uevents = make_unique<uevent_socket>("power_supply");
+    } catch (const system_error& err) {
+      m_log.warn("%s: Failed to listen for power supply events, polling instead (%s)", name(), err.what());
     }
 
-    m_capacity_reader = make_unique<capacity_reader>([=] {
-      auto cap_now = std::strtoul(file_util::contents(m_fcapnow).c_str(), nullptr, 10);
-      auto cap_max = std::strtoul(file_util::contents(m_fcapfull).c_str(), nullptr, 10);
-      return math_util::percentage(cap_now, 0UL, cap_max);
-    });
-
-    // Make rate reader
-    if ((m_fvoltage = file_util::pick({path_battery + "voltage_now"})).empty()) {
-      throw module_error("No suitable way to get current voltage value");
-    } else if ((m_frate = file_util::pick({path_battery + "current_now", path_battery + "power_now"})).empty()) {
-      throw module_error("No suitable way to get current charge rate value");
-    }
-
-    m_rate_reader = make_unique<rate_reader>([this] {
-      unsigned long rate{std::strtoul(file_util::contents(m_frate).c_str(), nullptr, 10) / 1000UL};
-      unsigned long volt{std::strtoul(file_util::contents(m_fvoltage).c_str(), nullptr, 10) / 1000UL};
-      unsigned long now{std::strtoul(file_util::contents(m_fcapnow).c_str(), nullptr, 10) / 1000UL};
-      unsigned long max{std::strtoul(file_util::contents(m_fcapfull).c_str(), nullptr, 10) / 1000UL};
-      unsigned long cap{read(*m_state_reader) ? max - now : now};
-
-      if (rate && volt && cap) {
-        return 3600UL * (cap * 1000UL / volt) / (rate * 1000UL / volt);
-      } else {
-        return 0UL;
-      }
-    });
-
-    // Load state and capacity level
-    m_state = current_state();
-    m_percentage = current_percentage(m_state);
-
     // Add formats and elements
     m_formatter->add(FORMAT_CHARGING, TAG_LABEL_CHARGING,
         {TAG_BAR_CAPACITY, TAG_RAMP_CAPACITY, TAG_ANIMATION_CHARGING, TAG_LABEL_CHARGING});
@@ -105,10 +63,6 @@ namespace modules {
       m_label_full = load_optional_label(m_conf, name(), TAG_LABEL_FULL, "%percentage%");
     }
 
-    // Create inotify watches
-    watch(m_fcapnow, IN_ACCESS);
-    watch(m_fstate, IN_ACCESS);
-
     // Setup time if token is used
     if ((m_label_charging && m_label_charging->has_token("%time%")) ||
         (m_label_discharging && m_label_discharging->has_token("%time%"))) {
@@ -120,88 +74,131 @@ namespace modules {
   }
 
   /**
-   * Dispatch the subthread used to update the
-   * charging animation when the module is started
+   * Start listening for events
+   *
+   * Not every battery reports a change of its capacity or rate,
+   * so the values are also re-read every poll-interval while
+   * waiting for the kernel events, 0 disables the polling
    */
   void battery_module::start() {
-    this->inotify_module::start();
-    m_subthread = thread(&battery_module::subthread, this);
+    event_module<battery_module>::start();
+
+    if (m_uevents && m_interval.count() > 0) {
+      m_poll = m_scheduler.add(m_interval, [this] { return poll(); });
+    }
   }
 
   /**
-   * Release wake lock when stopping the module
+   * Stop the polling and the charging animation
    */
   void battery_module::teardown() {
-    if (m_subthread.joinable()) {
-      m_subthread.join();
+    if (m_poll) {
+      m_scheduler.remove(m_poll);
+      m_poll = 0;
     }
+    animate(false);
   }
 
   /**
-   * Idle between polling inotify watches for events.
-   *
-   * If the defined interval has been reached, trigger a manual
-   * poll in case the inotify events aren't fired.
-   *
-   * This fallback is needed because some systems won't
-   * report inotify events for files on sysfs.
+   * Wait for the next update when the module isn't
+   * serviced by the event loop
    */
   void battery_module::idle() {
-    if (m_interval.count() > 0) {
-      auto now = chrono::system_clock::now();
-      if (chrono::duration_cast<decltype(m_interval)>(now - m_lastpoll) > m_interval) {
-        m_lastpoll = now;
-        m_log.info("%s: Polling values (inotify fallback)", name());
-        read(*m_capacity_reader);
-      }
+    if (m_uevents) {
+      m_uevents->poll(1000);
+    } else {
+      sleep(std::max(m_interval, chrono::duration<double>{1.0}));
     }
+  }
 
-    this->inotify_module::idle();
+  int battery_module::get_file_descriptor() const {
+    return m_uevents ? m_uevents->get_file_descriptor() : -1;
   }
 
   /**
-   * Update values when tracked files have changed
+   * Drain the queued power supply events and test if
+   * any of them concern the battery or adapter
    */
-  bool battery_module::on_event(inotify_event* event) {
-    auto state = current_state();
-    auto percentage = current_percentage(state);
+  bool battery_module::has_event() {
+    if (!m_uevents) {
+      return true;
+    }
 
-    // Reset timer to avoid unnecessary polling
-    m_lastpoll = chrono::system_clock::now();
+    bool matched{false};
 
-    if (event != nullptr) {
-      m_log.trace("%s: Inotify event reported for %s", name(), event->filename);
+    m_uevents->read([&](const uevent& event) {
+      auto device = event.name();
+      m_log.trace("%s: Power supply event '%s' for %s", name(), event.action, device);
+      matched |= device == m_battery->name() || device == m_battery->adapter();
+    });
 
-      if (state == m_state && percentage == m_percentage && m_unchanged--) {
-        return false;
-      }
+    return matched;
+  }
+
+  /**
+   * Fetch all values in one batch and update the labels
+   */
+  bool battery_module::update() {
+    if (!m_battery->update(!m_timeformat.empty())) {
+      return false;
+    }
 
-      m_unchanged = SKIP_N_UNCHANGED;
+    auto percentage = m_battery->percentage();
+    auto current = state::DISCHARGING;
+
+    if (m_battery->charging() && percentage < m_fullat) {
+      current = state::CHARGING;
+    } else if (m_battery->charging()) {
+      current = state::FULL;
+      percentage = 100;
     }
 
-    m_state = state;
+    m_state = current;
     m_percentage = percentage;
 
-    const auto label = [this] {
-      if (m_state == state::FULL) {
+    if (m_animation_charging) {
+      animate(current == state::CHARGING);
+    }
+
+    const auto label = [&] {
+      if (current == state::FULL) {
         return m_label_full;
-      } else if (m_state == state::DISCHARGING) {
+      } else if (current == state::DISCHARGING) {
         return m_label_discharging;
       } else {
         return m_label_charging;
       }
     }();
 
-    label->reset_tokens();
-    label->replace_token("%percentage%", to_string(m_percentage) + "%");
+    if (label) {
+      label->reset_tokens();
+      label->replace_token("%percentage%", to_string(m_percentage) + "%");
 
-    if (m_state != state::FULL && !m_timeformat.empty()) {
-      label->replace_token("%time%", current_time());
+      if (current != state::FULL && !m_timeformat.empty()) {
+        label->replace_token("%time%", current_time());
+      }
     }
 
     return true;
   }
 
+  /**
+   * Periodic update from the scheduler
+   *
+   * The round is skipped if the module is being updated or
+   * stopped, since teardown waits for this task to return
+   */
+  bool battery_module::poll() {
+    std::unique_lock<std::mutex> guard(m_updatelock, std::try_to_lock);
+
+    if (guard && running() && update()) {
+      invalidate();
+      return true;
+    }
+
+    return false;
+  }
+
   /**
    * Get the output format based on state
    */
@@ -218,59 +215,42 @@ namespace modules {
   /**
    * Generate module output using defined drawtypes
    */
-  bool battery_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_ANIMATION_CHARGING) {
-      builder->node(m_animation_charging->get());
-    } else if (tag == TAG_BAR_CAPACITY) {
-      builder->node(m_bar_capacity->output(m_percentage));
-    } else if (tag == TAG_RAMP_CAPACITY) {
-      builder->node(m_ramp_capacity->get_by_percentage(m_percentage));
-    } else if (tag == TAG_LABEL_CHARGING) {
-      builder->node(m_label_charging);
-    } else if (tag == TAG_LABEL_DISCHARGING) {
-      builder->node(m_label_discharging);
-    } else if (tag == TAG_LABEL_FULL) {
-      builder->node(m_label_full);
-    } else {
-      return false;
+  bool battery_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_ANIMATION_CHARGING):
+        builder->node(m_animation_charging->get());
+        break;
+      case tag_id(TAG_BAR_CAPACITY):
+        builder->node(m_bar_capacity->output(m_percentage));
+        break;
+      case tag_id(TAG_RAMP_CAPACITY):
+        builder->node(m_ramp_capacity->get_by_percentage(m_percentage));
+        break;
+      case tag_id(TAG_LABEL_CHARGING):
+        builder->node(m_label_charging);
+        break;
+      case tag_id(TAG_LABEL_DISCHARGING):
+        builder->node(m_label_discharging);
+        break;
+      case tag_id(TAG_LABEL_FULL):
+        builder->node(m_label_full);
+        break;
+      default:
+        return false;
     }
 
     return true;
   }
 
-  /**
-   * Get the current battery state
-   */
-  battery_module::state battery_module::current_state() {
-    if (!read(*m_state_reader)) {
-      return state::DISCHARGING;
-    } else if (read(*m_capacity_reader) < m_fullat) {
-      return state::CHARGING;
-    } else {
-      return state::FULL;
-    }
-  }
-
-  /**
-   * Get the current capacity level
-   */
-  int battery_module::current_percentage(state state) {
-    int percentage{read(*m_capacity_reader)};
-    if (state == state::FULL && percentage >= m_fullat) {
-      percentage = 100;
-    }
-    return percentage;
-  }
-
   /**
    * Get estimate of remaining time until fully dis-/charged
    */
-  string battery_module::current_time() {
+  string battery_module::current_time() const {
     struct tm t {
       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, nullptr
     };
 
-    chrono::seconds sec{read(*m_rate_reader)};
+    chrono::seconds sec{m_battery->seconds()};
     if (sec.count() > 0) {
       t.tm_hour = chrono::duration_cast<chrono::hours>(sec).count();
       sec -= chrono::seconds{3600 * t.tm_hour};
@@ -285,28 +265,20 @@ namespace modules {
   }
 
   /**
-   * Subthread runner that emit update events
-   * to refresh <animation-charging> in case it is used.
+   * Redraw the charging animation from the shared
+   * scheduler for as long as the battery is charging
    */
-  void battery_module::subthread() {
-    chrono::duration<double> dur{0.0};
-
-    if (m_animation_charging) {
-      dur += chrono::milliseconds{m_animation_charging->framerate()};
-    } else {
-      dur += 1s;
+  void battery_module::animate(bool enable) {
+    if (enable && !m_animation) {
+      chrono::duration<double> framerate{chrono::milliseconds{m_animation_charging->framerate()}};
+      m_animation = m_scheduler.add(framerate, [this] {
+        this->invalidate();
+        return true;
+      });
+    } else if (!enable && m_animation) {
+      m_scheduler.remove(m_animation);
+      m_animation = 0;
     }
-
-    while (running()) {
-      for (int i = 0; running() && i < dur.count(); ++i) {
-        if (m_state == state::CHARGING) {
-          broadcast();
-        }
-        sleep(dur);
-      }
-    }
-
-    m_log.trace("%s: End of subthread", name());
   }
 }
 
@@ -129,6 +129,10 @@ namespace modules {
     event_module::stop();
   }
 
+  int bspwm_module::get_file_descriptor() const {
+    return m_subscriber ? m_subscriber->get_file_descriptor() : -1;
+  }
+
   bool bspwm_module::has_event() {
     if (m_subscriber->poll(POLLHUP, 0)) {
       m_log.warn("%s: Reconnecting to socket...", name());
@@ -364,48 +368,61 @@ namespace modules {
     return output;
   }
 
-  bool bspwm_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL_MONITOR) {
-      builder->node(m_monitors[m_index]->label);
-      return true;
-    } else if (tag == TAG_LABEL_STATE && !m_monitors[m_index]->workspaces.empty()) {
-      size_t workspace_n{0U};
+  bool bspwm_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL_MONITOR):
+        builder->node(m_monitors[m_index]->label);
+        return true;
 
-      if (m_scroll) {
-        builder->cmd(mousebtn::SCROLL_DOWN, EVENT_SCROLL_DOWN);
-        builder->cmd(mousebtn::SCROLL_UP, EVENT_SCROLL_UP);
-      }
+      case tag_id(TAG_LABEL_STATE): {
+        if (m_monitors[m_index]->workspaces.empty()) {
+          return false;
+        }
 
-      for (auto&& ws : m_monitors[m_index]->workspaces) {
-        if (ws.second.get()) {
-          if (m_click) {
-            builder->cmd(mousebtn::LEFT, EVENT_CLICK + to_string(m_index) + "+" + to_string(++workspace_n));
-            builder->node(ws.second);
-            builder->cmd_close();
-          } else {
-            workspace_n++;
-            builder->node(ws.second);
+        size_t workspace_n{0U};
+
+        if (m_scroll) {
+          builder->cmd(mousebtn::SCROLL_DOWN, EVENT_SCROLL_DOWN);
+          builder->cmd(mousebtn::SCROLL_UP, EVENT_SCROLL_UP);
+        }
+
+        for (auto&& ws : m_monitors[m_index]->workspaces) {
+          if (ws.second.get()) {
+            if (m_click) {
+              builder->cmd(mousebtn::LEFT, EVENT_CLICK + to_string(m_index) + "+" + to_string(++workspace_n));
+              builder->node(ws.second);
+              builder->cmd_close();
+            } else {
+              workspace_n++;
+              builder->node(ws.second);
+            }
           }
         }
-      }
 
-      if (m_scroll) {
-        builder->cmd_close();
-        builder->cmd_close();
+        if (m_scroll) {
+          builder->cmd_close();
+          builder->cmd_close();
+        }
+
+        return workspace_n > 0;
       }
 
-      return workspace_n > 0;
-    } else if (tag == TAG_LABEL_MODE && m_monitors[m_index]->focused && !m_monitors[m_index]->modes.empty()) {
-      int modes_n = 0;
+      case tag_id(TAG_LABEL_MODE): {
+        if (!m_monitors[m_index]->focused || m_monitors[m_index]->modes.empty()) {
+          return false;
+        }
+
+        int modes_n = 0;
 
-      for (auto&& mode : m_monitors[m_index]->modes) {
-        if (*mode.get()) {
-          builder->node(mode);
-          modes_n++;
+        for (auto&& mode : m_monitors[m_index]->modes) {
+          if (*mode.get()) {
+            builder->node(mode);
+            modes_n++;
+          }
         }
-      }
 
-      return modes_n > 0;
+        return modes_n > 0;
+      }
     }
 
     return false;
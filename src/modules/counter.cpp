@@ -18,10 +18,11 @@ namespace modules {
     return true;
   }
 
-  bool counter_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_COUNTER) {
-      builder->node(to_string(m_counter));
-      return true;
+  bool counter_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_COUNTER):
+        builder->node(to_string(m_counter));
+        return true;
     }
     return false;
   }
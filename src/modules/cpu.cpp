@@ -1,12 +1,8 @@
-#include <fstream>
-#include <istream>
-
 #include "modules/cpu.hpp"
 
 #include "drawtypes/label.hpp"
 #include "drawtypes/progressbar.hpp"
 #include "drawtypes/ramp.hpp"
-#include "utils/math.hpp"
 
 #include "modules/meta/base.inl"
 
@@ -31,129 +27,92 @@ namespace modules {
     }
     if (m_formatter->has(TAG_LABEL)) {
       m_label = load_optional_label(m_conf, name(), TAG_LABEL, "%percentage%");
+      m_slot_percentage = m_label->slot("%percentage%");
+      m_slot_cores = m_label->slot("%percentage-cores%");
     }
 
-    // warmup
-    read_values();
-    read_values();
+    m_stat = sampler::make().cpu(m_interval);
   }
 
   bool cpu_module::update() {
-    if (!read_values()) {
-      return false;
-    }
-
-    m_total = 0.0f;
-    m_load.clear();
-
-    auto cores_n = m_cputimes.size();
+    auto sample = m_stat.get();
 
-    if (!cores_n) {
+    if (!sample) {
+      m_log.err("Failed to read CPU values (path: %s)", m_stat.path());
+      return false;
+    } else if (!sample->cores || sample == m_sample) {
       return false;
     }
 
-    vector<string> percentage_cores;
-    for (size_t i = 0; i < cores_n; i++) {
-      auto load = get_load(i);
-      m_total += load;
-      m_load.emplace_back(load);
-
-      if (m_label) {
-        percentage_cores.emplace_back(to_string(static_cast<int>(load + 0.5f)) + "%");
-      }
-    }
-
-    m_total = m_total / static_cast<float>(cores_n);
+    // compared against the last sample used by this module, since
+    // the source may have been read for other modules in between
+    m_load = cpu_load{m_sample.get(), *sample};
+    m_sample = move(sample);
 
     if (m_label) {
-      m_label->reset_tokens();
-      m_label->replace_token("%percentage%", to_string(static_cast<int>(m_total + 0.5f)) + "%");
-      m_label->replace_token("%percentage-cores%", string_util::join(percentage_cores, " "));
+      const auto percentage = [](float load) { return to_string(static_cast<int>(load + 0.5f)) + "%"; };
 
-      size_t i{0};
-      for (auto&& p : percentage_cores) {
-        m_label->replace_token("%percentage-core" + to_string(++i) + "%", p);
+      // the core count is only known once the first sample is read
+      if (m_slot_core.size() != m_load.cores.size()) {
+        m_slot_core.resize(m_load.cores.size());
+        for (size_t i = 0; i < m_slot_core.size(); i++) {
+          m_slot_core[i] = m_label->slot("%percentage-core" + to_string(i + 1) + "%");
+        }
       }
-    }
 
-    return true;
-  }
-
-  bool cpu_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL) {
-      builder->node(m_label);
-    } else if (tag == TAG_BAR_LOAD) {
-      builder->node(m_barload->output(m_total));
-    } else if (tag == TAG_RAMP_LOAD) {
-      builder->node(m_rampload->get_by_percentage(m_total));
-    } else if (tag == TAG_RAMP_LOAD_PER_CORE) {
-      auto i = 0;
-      for (auto&& load : m_load) {
-        if (i++ > 0) {
-          builder->space(1);
+      m_label->reset_tokens();
+      m_label->replace_token(m_slot_percentage, percentage(m_load.average));
+
+      if (m_slot_cores != -1) {
+        string cores;
+        for (auto&& load : m_load.cores) {
+          if (!cores.empty()) {
+            cores += ' ';
+          }
+          cores += percentage(load);
         }
-        builder->node(m_rampload_core->get_by_percentage(load));
+        m_label->replace_token(m_slot_cores, move(cores));
       }
-      builder->node(builder->flush());
-    } else {
-      return false;
-    }
-    return true;
-  }
-
-  bool cpu_module::read_values() {
-    m_cputimes_prev.swap(m_cputimes);
-    m_cputimes.clear();
 
-    try {
-      std::ifstream in(PATH_CPU_INFO);
-      string str;
-
-      while (std::getline(in, str) && str.compare(0, 3, "cpu") == 0) {
-        // skip line with accumulated value
-        if (str.compare(0, 4, "cpu ") == 0) {
-          continue;
+      for (size_t i = 0; i < m_slot_core.size(); i++) {
+        if (m_slot_core[i] != -1) {
+          m_label->replace_token(m_slot_core[i], percentage(m_load.cores[i]));
         }
-
-        auto values = string_util::split(str, ' ');
-
-        m_cputimes.emplace_back(new cpu_time);
-        m_cputimes.back()->user = std::stoull(values[1], nullptr, 10);
-        m_cputimes.back()->nice = std::stoull(values[2], nullptr, 10);
-        m_cputimes.back()->system = std::stoull(values[3], nullptr, 10);
-        m_cputimes.back()->idle = std::stoull(values[4], nullptr, 10);
-        m_cputimes.back()->total =
-            m_cputimes.back()->user + m_cputimes.back()->nice + m_cputimes.back()->system + m_cputimes.back()->idle;
       }
-    } catch (const std::ios_base::failure& e) {
-      m_log.err("Failed to read CPU values (what: %s)", e.what());
     }
 
-    return !m_cputimes.empty();
+    return true;
   }
 
-  float cpu_module::get_load(size_t core) const {
-    if (m_cputimes.empty() || m_cputimes_prev.empty()) {
-      return 0;
-    } else if (core >= m_cputimes.size() || core >= m_cputimes_prev.size()) {
-      return 0;
-    }
-
-    auto& last = m_cputimes[core];
-    auto& prev = m_cputimes_prev[core];
-
-    auto last_idle = last->idle;
-    auto prev_idle = prev->idle;
-
-    auto diff = last->total - prev->total;
-
-    if (diff == 0) {
-      return 0;
+  bool cpu_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL):
+        builder->node(m_label);
+        break;
+      case tag_id(TAG_BAR_LOAD):
+        builder->node(m_barload->output(m_load.average));
+        break;
+      case tag_id(TAG_RAMP_LOAD):
+        builder->node(m_rampload->get_by_percentage(m_load.average));
+        break;
+      case tag_id(TAG_RAMP_LOAD_PER_CORE): {
+        if (m_load.cores.empty()) {
+          return false;
+        }
+        auto i = 0;
+        for (auto&& load : m_load.cores) {
+          if (i++ > 0) {
+            builder->space(1);
+          }
+          builder->node(m_rampload_core->get_by_percentage(load));
+        }
+        builder->node(builder->flush());
+        break;
+      }
+      default:
+        return false;
     }
-
-    float percentage = 100.0f * (diff - (last_idle - prev_idle)) / diff;
-
-    return math_util::cap<float>(percentage, 0, 100);
+    return true;
   }
 }
 
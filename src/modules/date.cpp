@@ -29,8 +29,9 @@ namespace modules {
     if (m_formatter->has(TAG_DATE)) {
       m_log.warn("%s: The format tag `<date>` is deprecated, use `<label>` instead.", name());
 
-      m_formatter->get(DEFAULT_FORMAT)->value =
-          string_util::replace_all(m_formatter->get(DEFAULT_FORMAT)->value, TAG_DATE, TAG_LABEL);
+      auto format = m_formatter->get(DEFAULT_FORMAT);
+      format->value = string_util::replace_all(format->value, TAG_DATE, TAG_LABEL);
+      format->compile();
     }
 
     if (m_formatter->has(TAG_LABEL)) {
@@ -68,17 +69,19 @@ namespace modules {
     return true;
   }
 
-  bool date_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL) {
-      if (!m_dateformat_alt.empty() || !m_timeformat_alt.empty()) {
-        builder->cmd(mousebtn::LEFT, EVENT_TOGGLE);
-        builder->node(m_label);
-        builder->cmd_close();
-      } else {
-        builder->node(m_label);
-      }
-    } else {
-      return false;
+  bool date_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL):
+        if (!m_dateformat_alt.empty() || !m_timeformat_alt.empty()) {
+          builder->cmd(mousebtn::LEFT, EVENT_TOGGLE);
+          builder->node(m_label);
+          builder->cmd_close();
+        } else {
+          builder->node(m_label);
+        }
+        break;
+      default:
+        return false;
     }
 
     return true;
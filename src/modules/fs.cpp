@@ -143,32 +143,38 @@ namespace modules {
   /**
    * Output content using configured format tags
    */
-  bool fs_module::build(builder* builder, const string& tag) const {
+  bool fs_module::build(builder* builder, tag_t tag) const {
     auto& mount = m_mounts[m_index];
 
-    if (tag == TAG_BAR_FREE) {
-      builder->node(m_barfree->output(mount->percentage_free));
-    } else if (tag == TAG_BAR_USED) {
-      builder->node(m_barused->output(mount->percentage_used));
-    } else if (tag == TAG_RAMP_CAPACITY) {
-      builder->node(m_rampcapacity->get_by_percentage(mount->percentage_free));
-    } else if (tag == TAG_LABEL_MOUNTED) {
-      m_labelmounted->reset_tokens();
-      m_labelmounted->replace_token("%mountpoint%", mount->mountpoint);
-      m_labelmounted->replace_token("%type%", mount->type);
-      m_labelmounted->replace_token("%fsname%", mount->fsname);
-      m_labelmounted->replace_token("%percentage_free%", mount->percentage_free_s + "%");
-      m_labelmounted->replace_token("%percentage_used%", mount->percentage_used_s + "%");
-      m_labelmounted->replace_token("%total%", string_util::filesize(mount->bytes_total, 1, m_fixed, m_bar.locale));
-      m_labelmounted->replace_token("%free%", string_util::filesize(mount->bytes_free, 2, m_fixed, m_bar.locale));
-      m_labelmounted->replace_token("%used%", string_util::filesize(mount->bytes_used, 2, m_fixed, m_bar.locale));
-      builder->node(m_labelmounted);
-    } else if (tag == TAG_LABEL_UNMOUNTED) {
-      m_labelunmounted->reset_tokens();
-      m_labelunmounted->replace_token("%mountpoint%", mount->mountpoint);
-      builder->node(m_labelunmounted);
-    } else {
-      return false;
+    switch (tag) {
+      case tag_id(TAG_BAR_FREE):
+        builder->node(m_barfree->output(mount->percentage_free));
+        break;
+      case tag_id(TAG_BAR_USED):
+        builder->node(m_barused->output(mount->percentage_used));
+        break;
+      case tag_id(TAG_RAMP_CAPACITY):
+        builder->node(m_rampcapacity->get_by_percentage(mount->percentage_free));
+        break;
+      case tag_id(TAG_LABEL_MOUNTED):
+        m_labelmounted->reset_tokens();
+        m_labelmounted->replace_token("%mountpoint%", mount->mountpoint);
+        m_labelmounted->replace_token("%type%", mount->type);
+        m_labelmounted->replace_token("%fsname%", mount->fsname);
+        m_labelmounted->replace_token("%percentage_free%", mount->percentage_free_s + "%");
+        m_labelmounted->replace_token("%percentage_used%", mount->percentage_used_s + "%");
+        m_labelmounted->replace_token("%total%", string_util::filesize(mount->bytes_total, 1, m_fixed, m_bar.locale));
+        m_labelmounted->replace_token("%free%", string_util::filesize(mount->bytes_free, 2, m_fixed, m_bar.locale));
+        m_labelmounted->replace_token("%used%", string_util::filesize(mount->bytes_used, 2, m_fixed, m_bar.locale));
+        builder->node(m_labelmounted);
+        break;
+      case tag_id(TAG_LABEL_UNMOUNTED):
+        m_labelunmounted->reset_tokens();
+        m_labelunmounted->replace_token("%mountpoint%", mount->mountpoint);
+        builder->node(m_labelunmounted);
+        break;
+      default:
+        return false;
     }
 
     return true;
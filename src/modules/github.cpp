@@ -61,11 +61,13 @@ namespace modules {
   /**
    * Build module content
    */
-  bool github_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL) {
-      builder->node(m_label);
-    } else {
-      return false;
+  bool github_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL):
+        builder->node(m_label);
+        break;
+      default:
+        return false;
     }
     return true;
   }
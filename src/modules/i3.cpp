@@ -94,6 +94,10 @@ namespace modules {
     event_module::stop();
   }
 
+  int i3_module::get_file_descriptor() const {
+    return m_ipc ? m_ipc->get_event_socket_fd() : -1;
+  }
+
   bool i3_module::has_event() {
     try {
       m_ipc->handle_event();
@@ -161,31 +165,41 @@ namespace modules {
     }
   }
 
-  bool i3_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL_MODE && m_modeactive) {
-      builder->node(m_modelabel);
-    } else if (tag == TAG_LABEL_STATE && !m_workspaces.empty()) {
-      if (m_scroll) {
-        builder->cmd(mousebtn::SCROLL_DOWN, EVENT_SCROLL_DOWN);
-        builder->cmd(mousebtn::SCROLL_UP, EVENT_SCROLL_UP);
-      }
+  bool i3_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL_MODE):
+        if (!m_modeactive) {
+          return false;
+        }
+        builder->node(m_modelabel);
+        break;
+      case tag_id(TAG_LABEL_STATE):
+        if (m_workspaces.empty()) {
+          return false;
+        }
 
-      for (auto&& ws : m_workspaces) {
-        if (m_click) {
-          builder->cmd(mousebtn::LEFT, string{EVENT_CLICK} + to_string(ws->index));
-          builder->node(ws->label);
-          builder->cmd_close();
-        } else {
-          builder->node(ws->label);
+        if (m_scroll) {
+          builder->cmd(mousebtn::SCROLL_DOWN, EVENT_SCROLL_DOWN);
+          builder->cmd(mousebtn::SCROLL_UP, EVENT_SCROLL_UP);
         }
-      }
 
-      if (m_scroll) {
-        builder->cmd_close();
-        builder->cmd_close();
-      }
-    } else {
-      return false;
+        for (auto&& ws : m_workspaces) {
+          if (m_click) {
+            builder->cmd(mousebtn::LEFT, string{EVENT_CLICK} + to_string(ws->index));
+            builder->node(ws->label);
+            builder->cmd_close();
+          } else {
+            builder->node(ws->label);
+          }
+        }
+
+        if (m_scroll) {
+          builder->cmd_close();
+          builder->cmd_close();
+        }
+        break;
+      default:
+        return false;
     }
 
     return true;
@@ -66,11 +66,13 @@ namespace modules {
   /**
    * Output content retrieved from hook commands
    */
-  bool ipc_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_OUTPUT) {
-      builder->node(m_output);
-    } else {
-      return false;
+  bool ipc_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_OUTPUT):
+        builder->node(m_output);
+        break;
+      default:
+        return false;
     }
     return true;
   }
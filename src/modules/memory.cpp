@@ -1,6 +1,4 @@
-#include <fstream>
 #include <iomanip>
-#include <istream>
 
 #include "modules/memory.hpp"
 
@@ -27,39 +25,26 @@ namespace modules {
     }
     if (m_formatter->has(TAG_LABEL)) {
       m_label = load_optional_label(m_conf, name(), TAG_LABEL, "%percentage_used%");
+
+      const char* tokens[SLOTS]{"%gb_used%", "%gb_free%", "%gb_total%", "%mb_used%", "%mb_free%", "%mb_total%",
+          "%percentage_used%", "%percentage_free%"};
+      for (size_t i = 0; i < SLOTS; i++) {
+        m_slots[i] = m_label->slot(tokens[i]);
+      }
     }
+
+    m_meminfo = sampler::make().memory(m_interval);
   }
 
   bool memory_module::update() {
-    float kb_total;
-    float kb_avail;
-    // long kb_free;
-
-    try {
-      std::ifstream in(PATH_MEMORY_INFO);
-      std::stringstream buffer;
-      string str, rdbuf;
-      int i = 0;
-
-      in.exceptions(in.failbit);
+    float kb_total{0.0f};
+    float kb_avail{0.0f};
 
-      buffer.imbue(std::locale::classic());
-
-      while (std::getline(in, str) && i++ < 3) {
-        size_t off = str.find_first_of("1234567890", str.find(':'));
-        buffer << std::strtol(&str[off], nullptr, 10) << std::endl;
-      }
-
-      buffer >> rdbuf;
-      kb_total = std::atol(rdbuf.c_str());
-      buffer >> rdbuf;  // kb_free = std::atol(rdbuf.c_str());
-      buffer >> rdbuf;
-      kb_avail = std::atol(rdbuf.c_str());
-    } catch (const std::ios_base::failure& e) {
-      kb_total = 0;
-      // kb_free = 0;
-      kb_avail = 0;
-      m_log.err("Failed to read memory values (what: %s)", e.what());
+    if (auto sample = m_meminfo.get()) {
+      kb_total = sample->kb_total;
+      kb_avail = sample->kb_avail;
+    } else {
+      m_log.err("Failed to read memory values (path: %s)", m_meminfo.path());
     }
 
     if (kb_total > 0) {
@@ -74,35 +59,40 @@ namespace modules {
     if (m_label) {
       m_label->reset_tokens();
 
-      auto replace_unit = [](label_t& label, string token, float value, string unit) {
-        auto formatted =
-            string_util::from_stream(stringstream() << std::setprecision(2) << std::fixed << value << " " << unit);
-        label->replace_token(token, formatted);
+      auto replace_unit = [&](label_slot slot, float value, string unit) {
+        if (m_slots[slot] != -1) {
+          m_label->replace_token(m_slots[slot],
+              string_util::from_stream(stringstream() << std::setprecision(2) << std::fixed << value << " " << unit));
+        }
       };
 
-      replace_unit(m_label, "%gb_used%", (kb_total - kb_avail) / 1024 / 1024, "GB");
-      replace_unit(m_label, "%gb_free%", kb_avail / 1024 / 1024, "GB");
-      replace_unit(m_label, "%gb_total%", kb_total / 1024 / 1024, "GB");
-      replace_unit(m_label, "%mb_used%", (kb_total - kb_avail) / 1024, "MB");
-      replace_unit(m_label, "%mb_free%", kb_avail / 1024, "MB");
-      replace_unit(m_label, "%mb_total%", kb_total / 1024, "MB");
+      replace_unit(GB_USED, (kb_total - kb_avail) / 1024 / 1024, "GB");
+      replace_unit(GB_FREE, kb_avail / 1024 / 1024, "GB");
+      replace_unit(GB_TOTAL, kb_total / 1024 / 1024, "GB");
+      replace_unit(MB_USED, (kb_total - kb_avail) / 1024, "MB");
+      replace_unit(MB_FREE, kb_avail / 1024, "MB");
+      replace_unit(MB_TOTAL, kb_total / 1024, "MB");
 
-      m_label->replace_token("%percentage_used%", to_string(m_perc[memtype::USED]) + "%");
-      m_label->replace_token("%percentage_free%", to_string(m_perc[memtype::FREE]) + "%");
+      m_label->replace_token(m_slots[PERCENTAGE_USED], to_string(m_perc[memtype::USED]) + "%");
+      m_label->replace_token(m_slots[PERCENTAGE_FREE], to_string(m_perc[memtype::FREE]) + "%");
     }
 
     return true;
   }
 
-  bool memory_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_BAR_USED) {
-      builder->node(m_bars.at(memtype::USED)->output(m_perc.at(memtype::USED)));
-    } else if (tag == TAG_BAR_FREE) {
-      builder->node(m_bars.at(memtype::FREE)->output(m_perc.at(memtype::FREE)));
-    } else if (tag == TAG_LABEL) {
-      builder->node(m_label);
-    } else {
-      return false;
+  bool memory_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_BAR_USED):
+        builder->node(m_bars.at(memtype::USED)->output(m_perc.at(memtype::USED)));
+        break;
+      case tag_id(TAG_BAR_FREE):
+        builder->node(m_bars.at(memtype::FREE)->output(m_perc.at(memtype::FREE)));
+        break;
+      case tag_id(TAG_LABEL):
+        builder->node(m_label);
+        break;
+      default:
+        return false;
     }
     return true;
   }
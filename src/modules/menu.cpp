@@ -53,29 +53,37 @@ namespace modules {
     }
   }
 
-  bool menu_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL_TOGGLE && m_level == -1) {
-      builder->cmd(mousebtn::LEFT, string(EVENT_MENU_OPEN) + "0");
-      builder->node(m_labelopen);
-      builder->cmd_close();
-    } else if (tag == TAG_LABEL_TOGGLE && m_level > -1) {
-      builder->cmd(mousebtn::LEFT, EVENT_MENU_CLOSE);
-      builder->node(m_labelclose);
-      builder->cmd_close();
-    } else if (tag == TAG_MENU && m_level > -1) {
-      for (auto&& item : m_levels[m_level]->items) {
-        if (item != m_levels[m_level]->items.front()) {
-          builder->space();
+  bool menu_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL_TOGGLE):
+        if (m_level == -1) {
+          builder->cmd(mousebtn::LEFT, string(EVENT_MENU_OPEN) + "0");
+          builder->node(m_labelopen);
+          builder->cmd_close();
+        } else {
+          builder->cmd(mousebtn::LEFT, EVENT_MENU_CLOSE);
+          builder->node(m_labelclose);
+          builder->cmd_close();
         }
-        if (*m_labelseparator) {
-          builder->node(m_labelseparator, true);
+        break;
+      case tag_id(TAG_MENU):
+        if (m_level == -1) {
+          return false;
         }
-        builder->cmd(mousebtn::LEFT, item->exec);
-        builder->node(item->label);
-        builder->cmd_close();
-      }
-    } else {
-      return false;
+        for (auto&& item : m_levels[m_level]->items) {
+          if (item != m_levels[m_level]->items.front()) {
+            builder->space();
+          }
+          if (*m_labelseparator) {
+            builder->node(m_labelseparator, true);
+          }
+          builder->cmd(mousebtn::LEFT, item->exec);
+          builder->node(item->label);
+          builder->cmd_close();
+        }
+        break;
+      default:
+        return false;
     }
     return true;
   }
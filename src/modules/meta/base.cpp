@@ -9,6 +9,24 @@ POLYBAR_NS
 namespace modules {
   // module_format {{{
 
+  /**
+   * Split the format value into the nodes used when building
+   * the module output, must be called after changing the value
+   */
+  void module_format::compile() {
+    nodes.clear();
+
+    for (auto&& token : string_util::split(value, ' ')) {
+      if (token.empty()) {
+        nodes.emplace_back(format_node{format_op::SPACE, 0U, ""});
+      } else if (token.front() == '<' && token.back() == '>') {
+        nodes.emplace_back(format_node{format_op::TAG, tag_id(token.c_str()), move(token)});
+      } else {
+        nodes.emplace_back(format_node{format_op::TEXT, 0U, move(token)});
+      }
+    }
+  }
+
   string module_format::decorate(builder* builder, string output) {
     if (output.empty()) {
       builder->flush();
@@ -96,15 +114,17 @@ namespace modules {
       // suffix not defined
     }
 
-    for (auto&& tag : string_util::split(format->value, ' ')) {
-      if (tag[0] != '<' || tag[tag.length() - 1] != '>') {
+    format->compile();
+
+    for (auto&& node : format->nodes) {
+      if (node.op != format_op::TAG) {
         continue;
-      } else if (find(format->tags.begin(), format->tags.end(), tag) != format->tags.end()) {
+      } else if (find(format->tags.begin(), format->tags.end(), node.text) != format->tags.end()) {
         continue;
-      } else if (find(whitelist.begin(), whitelist.end(), tag) != whitelist.end()) {
+      } else if (find(whitelist.begin(), whitelist.end(), node.text) != whitelist.end()) {
         continue;
       } else {
-        throw undefined_format_tag(tag + " is not a valid format tag for \"" + name + "\"");
+        throw undefined_format_tag(node.text + " is not a valid format tag for \"" + name + "\"");
       }
     }
 
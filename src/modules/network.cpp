@@ -61,9 +61,9 @@ namespace modules {
 
     // Get an intstance of the network interface
     if (net::is_wireless_interface(m_interface)) {
-      m_wireless = factory_util::unique<net::wireless_network>(m_interface);
+      m_wireless = factory_util::unique<net::wireless_network>(m_interface, m_interval);
     } else {
-      m_wired = factory_util::unique<net::wired_network>(m_interface);
+      m_wired = factory_util::unique<net::wired_network>(m_interface, m_interval);
     };
 
     // We only need to start the subthread if the packetloss animation is used
@@ -145,21 +145,28 @@ namespace modules {
     }
   }
 
-  bool network_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL_CONNECTED) {
-      builder->node(m_label.at(connection_state::CONNECTED));
-    } else if (tag == TAG_LABEL_DISCONNECTED) {
-      builder->node(m_label.at(connection_state::DISCONNECTED));
-    } else if (tag == TAG_LABEL_PACKETLOSS) {
-      builder->node(m_label.at(connection_state::PACKETLOSS));
-    } else if (tag == TAG_ANIMATION_PACKETLOSS) {
-      builder->node(m_animation_packetloss->get());
-    } else if (tag == TAG_RAMP_SIGNAL) {
-      builder->node(m_ramp_signal->get_by_percentage(m_signal));
-    } else if (tag == TAG_RAMP_QUALITY) {
-      builder->node(m_ramp_quality->get_by_percentage(m_quality));
-    } else {
-      return false;
+  bool network_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL_CONNECTED):
+        builder->node(m_label.at(connection_state::CONNECTED));
+        break;
+      case tag_id(TAG_LABEL_DISCONNECTED):
+        builder->node(m_label.at(connection_state::DISCONNECTED));
+        break;
+      case tag_id(TAG_LABEL_PACKETLOSS):
+        builder->node(m_label.at(connection_state::PACKETLOSS));
+        break;
+      case tag_id(TAG_ANIMATION_PACKETLOSS):
+        builder->node(m_animation_packetloss->get());
+        break;
+      case tag_id(TAG_RAMP_SIGNAL):
+        builder->node(m_ramp_signal->get_by_percentage(m_signal));
+        break;
+      case tag_id(TAG_RAMP_QUALITY):
+        builder->node(m_ramp_quality->get_by_percentage(m_quality));
+        break;
+      default:
+        return false;
     }
     return true;
   }
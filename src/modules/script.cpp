@@ -134,13 +134,16 @@ namespace modules {
     return m_builder->flush();
   }
 
-  bool script_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_OUTPUT) {
-      builder->node(m_output);
-    } else if (tag == TAG_LABEL) {
-      builder->node(m_label);
-    } else {
-      return false;
+  bool script_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_OUTPUT):
+        builder->node(m_output);
+        break;
+      case tag_id(TAG_LABEL):
+        builder->node(m_label);
+        break;
+      default:
+        return false;
     }
 
     return true;
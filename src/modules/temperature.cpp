@@ -24,6 +24,8 @@ namespace modules {
       throw module_error("The file '" + m_path + "' does not exist");
     }
 
+    m_zonefile = sampler::make().thermal(m_path, m_interval);
+
     m_formatter->add(DEFAULT_FORMAT, TAG_LABEL, {TAG_LABEL, TAG_RAMP});
     m_formatter->add(FORMAT_WARN, TAG_LABEL_WARN, {TAG_LABEL_WARN, TAG_RAMP});
 
@@ -39,7 +41,15 @@ namespace modules {
   }
 
   bool temperature_module::update() {
-    m_temp = std::atoi(file_util::contents(m_path).c_str()) / 1000.0f + 0.5f;
+    long long millidegrees{0};
+
+    if (auto sample = m_zonefile.get()) {
+      millidegrees = sample->millidegrees;
+    } else {
+      m_log.err("%s: Failed to read temperature from '%s'", name(), m_path);
+    }
+
+    m_temp = millidegrees / 1000.0f + 0.5f;
     m_perc = math_util::cap(math_util::percentage(m_temp, 0, m_tempwarn), 0, 100);
 
     const auto replace_tokens = [&](label_t& label) {
@@ -65,15 +75,19 @@ namespace modules {
     }
   }
 
-  bool temperature_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL) {
-      builder->node(m_label.at(temp_state::NORMAL));
-    } else if (tag == TAG_LABEL_WARN) {
-      builder->node(m_label.at(temp_state::WARN));
-    } else if (tag == TAG_RAMP) {
-      builder->node(m_ramp->get_by_percentage(m_perc));
-    } else {
-      return false;
+  bool temperature_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL):
+        builder->node(m_label.at(temp_state::NORMAL));
+        break;
+      case tag_id(TAG_LABEL_WARN):
+        builder->node(m_label.at(temp_state::WARN));
+        break;
+      case tag_id(TAG_RAMP):
+        builder->node(m_ramp->get_by_percentage(m_perc));
+        break;
+      default:
+        return false;
     }
     return true;
   }
@@ -14,8 +14,9 @@ namespace modules {
       throw module_error(name() + ".content is empty or undefined");
     }
 
-    m_formatter->get("content")->value =
-        string_util::replace_all(m_formatter->get("content")->value, " ", BUILDER_SPACE_TOKEN);
+    auto format = m_formatter->get("content");
+    format->value = string_util::replace_all(format->value, " ", BUILDER_SPACE_TOKEN);
+    format->compile();
   }
 
   string text_module::get_format() const {
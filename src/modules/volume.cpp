@@ -189,19 +189,26 @@ namespace modules {
     return m_builder->flush();
   }
 
-  bool volume_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_BAR_VOLUME) {
-      builder->node(m_bar_volume->output(m_volume));
-    } else if (tag == TAG_RAMP_VOLUME && (!m_headphones || !*m_ramp_headphones)) {
-      builder->node(m_ramp_volume->get_by_percentage(m_volume));
-    } else if (tag == TAG_RAMP_VOLUME && m_headphones && *m_ramp_headphones) {
-      builder->node(m_ramp_headphones->get_by_percentage(m_volume));
-    } else if (tag == TAG_LABEL_VOLUME) {
-      builder->node(m_label_volume);
-    } else if (tag == TAG_LABEL_MUTED) {
-      builder->node(m_label_muted);
-    } else {
-      return false;
+  bool volume_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_BAR_VOLUME):
+        builder->node(m_bar_volume->output(m_volume));
+        break;
+      case tag_id(TAG_RAMP_VOLUME):
+        if (m_headphones && *m_ramp_headphones) {
+          builder->node(m_ramp_headphones->get_by_percentage(m_volume));
+        } else {
+          builder->node(m_ramp_volume->get_by_percentage(m_volume));
+        }
+        break;
+      case tag_id(TAG_LABEL_VOLUME):
+        builder->node(m_label_volume);
+        break;
+      case tag_id(TAG_LABEL_MUTED):
+        builder->node(m_label_muted);
+        break;
+      default:
+        return false;
     }
     return true;
   }
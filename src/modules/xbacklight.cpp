@@ -134,15 +134,19 @@ namespace modules {
   /**
    * Output content as defined in the config
    */
-  bool xbacklight_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_BAR) {
-      builder->node(m_progressbar->output(m_percentage));
-    } else if (tag == TAG_RAMP) {
-      builder->node(m_ramp->get_by_percentage(m_percentage));
-    } else if (tag == TAG_LABEL) {
-      builder->node(m_label);
-    } else {
-      return false;
+  bool xbacklight_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_BAR):
+        builder->node(m_progressbar->output(m_percentage));
+        break;
+      case tag_id(TAG_RAMP):
+        builder->node(m_ramp->get_by_percentage(m_percentage));
+        break;
+      case tag_id(TAG_LABEL):
+        builder->node(m_label);
+        break;
+      default:
+        return false;
     }
     return true;
   }
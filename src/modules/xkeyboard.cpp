@@ -97,20 +97,23 @@ namespace modules {
   /**
    * Map format tags to content
    */
-  bool xkeyboard_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL_LAYOUT) {
-      builder->node(m_layout);
-    } else if (tag == TAG_LABEL_INDICATOR) {
-      size_t n{0};
-      for (auto&& indicator : m_indicators) {
-        if (n++) {
-          builder->space(m_formatter->get(DEFAULT_FORMAT)->spacing);
+  bool xkeyboard_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL_LAYOUT):
+        builder->node(m_layout);
+        break;
+      case tag_id(TAG_LABEL_INDICATOR): {
+        size_t n{0};
+        for (auto&& indicator : m_indicators) {
+          if (n++) {
+            builder->space(m_formatter->get(DEFAULT_FORMAT)->spacing);
+          }
+          builder->node(indicator.second);
         }
-        builder->node(indicator.second);
+        return n > 0;
       }
-      return n > 0;
-    } else {
-      return false;
+      default:
+        return false;
     }
 
     return true;
@@ -124,10 +124,14 @@ namespace modules {
   /**
    * Output content as defined in the config
    */
-  bool xwindow_module::build(builder* builder, const string& tag) const {
-    if (tag == TAG_LABEL && m_label && m_label.get()) {
-      builder->node(m_label);
-      return true;
+  bool xwindow_module::build(builder* builder, tag_t tag) const {
+    switch (tag) {
+      case tag_id(TAG_LABEL):
+        if (m_label && m_label.get()) {
+          builder->node(m_label);
+          return true;
+        }
+        break;
     }
     return false;
   }
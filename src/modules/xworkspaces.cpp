@@ -164,42 +164,51 @@ namespace modules {
   /**
    * Output content as defined in the config
    */
-  bool xworkspaces_module::build(builder* builder, const string& tag) const {
+  bool xworkspaces_module::build(builder* builder, tag_t tag) const {
     if (m_index >= m_viewports.size()) {
       m_log.warn("%s: Invalid index (index=%lu, viewports=%lu)", name(), m_index, m_viewports.size());
-    } else if (tag == TAG_LABEL_MONITOR && m_viewports[m_index]->state != viewport_state::NONE) {
-      builder->node(m_viewports[m_index]->label);
-      return true;
-    } else if (tag == TAG_LABEL_STATE) {
-      size_t num{0};
-
-      if (m_scroll) {
-        builder->cmd(mousebtn::SCROLL_DOWN, string{EVENT_PREFIX} + string{EVENT_SCROLL_DOWN});
-        builder->cmd(mousebtn::SCROLL_UP, string{EVENT_PREFIX} + string{EVENT_SCROLL_UP});
-      }
+      return false;
+    }
 
-      for (auto&& desktop : m_viewports[m_index]->desktops) {
-        if (!desktop->label.get()) {
-          continue;
+    switch (tag) {
+      case tag_id(TAG_LABEL_MONITOR):
+        if (m_viewports[m_index]->state == viewport_state::NONE) {
+          return false;
         }
+        builder->node(m_viewports[m_index]->label);
+        return true;
 
-        if (m_click && desktop->state != desktop_state::ACTIVE) {
-          builder->cmd(mousebtn::LEFT, string{EVENT_PREFIX} + string{EVENT_CLICK} + to_string(desktop->index));
-          builder->node(desktop->label);
-          builder->cmd_close();
-        } else {
-          builder->node(desktop->label);
+      case tag_id(TAG_LABEL_STATE): {
+        size_t num{0};
+
+        if (m_scroll) {
+          builder->cmd(mousebtn::SCROLL_DOWN, string{EVENT_PREFIX} + string{EVENT_SCROLL_DOWN});
+          builder->cmd(mousebtn::SCROLL_UP, string{EVENT_PREFIX} + string{EVENT_SCROLL_UP});
         }
 
-        num++;
-      }
+        for (auto&& desktop : m_viewports[m_index]->desktops) {
+          if (!desktop->label.get()) {
+            continue;
+          }
 
-      if (m_scroll) {
-        builder->cmd_close();
-        builder->cmd_close();
-      }
+          if (m_click && desktop->state != desktop_state::ACTIVE) {
+            builder->cmd(mousebtn::LEFT, string{EVENT_PREFIX} + string{EVENT_CLICK} + to_string(desktop->index));
+            builder->node(desktop->label);
+            builder->cmd_close();
+          } else {
+            builder->node(desktop->label);
+          }
+
+          num++;
+        }
+
+        if (m_scroll) {
+          builder->cmd_close();
+          builder->cmd_close();
+        }
 
-      return num > 0;
+        return num > 0;
+      }
     }
 
     return false;
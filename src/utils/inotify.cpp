@@ -1,4 +1,6 @@
+#include <sys/eventfd.h>
 #include <unistd.h>
+#include <cerrno>
 
 #include "errors.hpp"
 #include "utils/inotify.hpp"
@@ -116,4 +118,122 @@ int inotify_watch::get_file_descriptor() const {
   return m_fd;
 }
 
+/**
+ * Construct watcher with a non-blocking inotify fd
+ */
+inotify_watcher::inotify_watcher() : m_buffer(4096) {
+  if ((m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) == -1) {
+    throw system_error("Failed to allocate inotify fd");
+  }
+  if ((m_wakeupfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+    close(m_fd);
+    throw system_error("Failed to allocate eventfd");
+  }
+}
+
+/**
+ * Deconstruct watcher, closing the fd removes all watches
+ */
+inotify_watcher::~inotify_watcher() {
+  close(m_wakeupfd);
+  close(m_fd);
+}
+
+/**
+ * Add a watch for given path, or update the mask
+ * if the path is already watched
+ */
+int inotify_watcher::attach(const string& path, int mask) {
+  int wd{inotify_add_watch(m_fd, path.c_str(), mask)};
+  if (wd == -1) {
+    throw system_error("Failed to attach inotify watch");
+  }
+  m_watches[wd] = path;
+  return wd;
+}
+
+/**
+ * Wait until events are queued or the poll is interrupted
+ *
+ * @brief A wait_ms of -1 blocks until an event is fired
+ */
+bool inotify_watcher::poll(int wait_ms) {
+  struct pollfd fds[2];
+  fds[0].fd = m_fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = m_wakeupfd;
+  fds[1].events = POLLIN;
+
+  if (::poll(fds, 2, wait_ms) <= 0) {
+    return false;
+  }
+
+  if (fds[1].revents & POLLIN) {
+    eventfd_t value;
+    eventfd_read(m_wakeupfd, &value);
+  }
+
+  return fds[0].revents & POLLIN;
+}
+
+/**
+ * Wake up a thread blocked in poll()
+ */
+void inotify_watcher::interrupt() {
+  eventfd_write(m_wakeupfd, 1);
+}
+
+/**
+ * Read all queued events and pass them to the callback
+ *
+ * Watches removed by the kernel, e.g. because the file was
+ * deleted, are reported with IN_IGNORED and forgotten
+ */
+size_t inotify_watcher::read(const callback& fn) {
+  size_t count{0U};
+
+  while (true) {
+    auto bytes = ::read(m_fd, m_buffer.data(), m_buffer.size());
+
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    } else if (bytes <= 0) {
+      break;
+    }
+
+    for (ssize_t len = 0; len < bytes; count++) {
+      auto* e = reinterpret_cast<::inotify_event*>(&m_buffer[len]);
+      len += sizeof(*e) + e->len;
+
+      auto watch = m_watches.find(e->wd);
+      if (watch == m_watches.end()) {
+        continue;
+      }
+
+      if (fn) {
+        inotify_event event{};
+        event.filename = e->len ? e->name : watch->second;
+        event.wd = e->wd;
+        event.cookie = e->cookie;
+        event.is_dir = e->mask & IN_ISDIR;
+        event.mask = e->mask;
+        fn(event);
+      }
+
+      if (e->mask & IN_IGNORED) {
+        m_watches.erase(watch);
+      }
+    }
+  }
+
+  return count;
+}
+
+/**
+ * Get the inotify fd
+ */
+int inotify_watcher::get_file_descriptor() const {
+  return m_fd;
+}
+
 POLYBAR_NS_END
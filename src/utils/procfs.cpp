@@ -0,0 +1,202 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+
+#include "utils/procfs.hpp"
+
+POLYBAR_NS
+
+// implementation of procfs_scanner {{{
+
+procfs_scanner::procfs_scanner(const char* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+bool procfs_scanner::eof() const {
+  return m_pos >= m_end;
+}
+
+/**
+ * Test if the text at the current position starts with prefix
+ */
+bool procfs_scanner::match(const char* prefix) const {
+  size_t len{strlen(prefix)};
+  return static_cast<size_t>(m_end - m_pos) >= len && memcmp(m_pos, prefix, len) == 0;
+}
+
+/**
+ * Move past the first line, from the current position,
+ * that starts with key
+ */
+bool procfs_scanner::seek(const char* key) {
+  while (!eof()) {
+    if (match(key)) {
+      m_pos += strlen(key);
+      return true;
+    }
+    next_line();
+  }
+  return false;
+}
+
+/**
+ * Move past the word at the current position
+ */
+void procfs_scanner::skip_word() {
+  while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t')) {
+    m_pos++;
+  }
+  while (m_pos < m_end && *m_pos != ' ' && *m_pos != '\t' && *m_pos != '\n') {
+    m_pos++;
+  }
+}
+
+/**
+ * Move to the beginning of the next line
+ */
+void procfs_scanner::next_line() {
+  auto newline = static_cast<const char*>(memchr(m_pos, '\n', m_end - m_pos));
+  m_pos = newline != nullptr ? newline + 1 : m_end;
+}
+
+/**
+ * Parse the next integer on the current line
+ */
+bool procfs_scanner::next(long long& value) {
+  while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == ':')) {
+    m_pos++;
+  }
+
+  bool negative{m_pos < m_end && *m_pos == '-'};
+  const char* start{negative ? m_pos + 1 : m_pos};
+  const char* pos{start};
+  unsigned long long result{0ULL};
+
+  while (pos < m_end && *pos >= '0' && *pos <= '9') {
+    result = result * 10 + static_cast<unsigned long long>(*pos++ - '0');
+  }
+
+  if (pos == start) {
+    return false;
+  }
+
+  m_pos = pos;
+  value = negative ? -static_cast<long long>(result) : static_cast<long long>(result);
+  return true;
+}
+
+/**
+ * Read the text up to delimiter on the current line,
+ * ignoring leading blanks, and move past the delimiter
+ */
+bool procfs_scanner::next(string& word, char delimiter) {
+  while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t')) {
+    m_pos++;
+  }
+
+  const char* pos{m_pos};
+
+  while (pos < m_end && *pos != delimiter && *pos != '\n') {
+    pos++;
+  }
+
+  if (pos == m_end || *pos != delimiter) {
+    return false;
+  }
+
+  word.assign(m_pos, pos);
+  m_pos = pos + 1;
+  return true;
+}
+
+// }}}
+// implementation of procfs_file {{{
+
+procfs_file::procfs_file(string path) : m_path(move(path)), m_buffer(BUFSIZ) {
+  open();
+}
+
+procfs_file::~procfs_file() {
+  close();
+}
+
+const string& procfs_file::path() const {
+  return m_path;
+}
+
+/**
+ * Fetch the current contents of the file
+ */
+bool procfs_file::read() {
+  m_size = 0;
+
+  if (m_fd == -1 && !open()) {
+    return false;
+  }
+
+  while (true) {
+    ssize_t bytes{pread(m_fd, m_buffer.data() + m_size, m_buffer.size() - m_size, m_size)};
+
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    } else if (bytes == -1) {
+      m_size = 0;
+      close();
+      return false;
+    } else if (bytes == 0) {
+      return true;
+    }
+
+    m_size += bytes;
+
+    if (m_size == m_buffer.size()) {
+      m_buffer.resize(m_buffer.size() * 2);
+    }
+  }
+}
+
+/**
+ * Fetch the contents and parse the leading integer
+ */
+bool procfs_file::read(long long& value) {
+  return read() && scan().next(value);
+}
+
+/**
+ * Fetch the contents and parse the leading integer as a float
+ */
+bool procfs_file::read(float& value) {
+  long long integer{0};
+  if (!read(integer)) {
+    return false;
+  }
+  value = static_cast<float>(integer);
+  return true;
+}
+
+const char* procfs_file::data() const {
+  return m_buffer.data();
+}
+
+size_t procfs_file::size() const {
+  return m_size;
+}
+
+procfs_scanner procfs_file::scan() const {
+  return procfs_scanner{m_buffer.data(), m_size};
+}
+
+bool procfs_file::open() {
+  m_fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+  return m_fd != -1;
+}
+
+void procfs_file::close() {
+  if (m_fd != -1) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+}
+
+// }}}
+
+POLYBAR_NS_END
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <limits>
+
+#include "utils/timer_wheel.hpp"
+
+POLYBAR_NS
+
+namespace {
+  /**
+   * Rotate the slot bitmap so that bit 0 represents the given slot
+   */
+  inline uint64_t rotate(uint64_t bits, size_t slot) {
+    slot &= 63U;
+    return slot ? (bits >> slot) | (bits << (64U - slot)) : bits;
+  }
+}
+
+/**
+ * Construct timer wheel starting at given tick
+ */
+timer_wheel::timer_wheel(tick_t now) : m_now(now) {}
+
+/**
+ * Schedule timer to expire at given tick
+ *
+ * Timers that are already due expire on the next tick.
+ * An existing timer with the same id is rescheduled.
+ */
+void timer_wheel::insert(id_t id, tick_t expires) {
+  remove(id);
+  auto& e = m_entries[id];
+  e.expires = expires;
+  place(id, e, std::max(expires, m_now + 1));
+}
+
+/**
+ * Cancel timer
+ */
+bool timer_wheel::remove(id_t id) {
+  auto it = m_entries.find(id);
+  if (it == m_entries.end()) {
+    return false;
+  }
+  unlink(it->second);
+  m_entries.erase(it);
+  return true;
+}
+
+/**
+ * Check if a timer with given id is scheduled
+ */
+bool timer_wheel::contains(id_t id) const {
+  return m_entries.find(id) != m_entries.end();
+}
+
+/**
+ * Move the wheel forward to the given tick and collect
+ * the ids of all expired timers in order of expiry
+ *
+ * Empty stretches of the wheel are skipped
+ */
+void timer_wheel::advance(tick_t to, vector<id_t>& expired) {
+  while (m_now < to) {
+    tick_t next{next_expiry()};
+
+    if (next > to) {
+      m_now = to;
+      break;
+    }
+
+    m_now = next;
+
+    for (size_t level = LEVELS - 1; level > 0; level--) {
+      size_t shift{SLOT_BITS * level};
+      if ((m_now & ((tick_t{1} << shift) - 1)) == 0) {
+        cascade(level, (m_now >> shift) & (SLOTS - 1));
+      }
+    }
+
+    expire(m_now & (SLOTS - 1), expired);
+  }
+}
+
+/**
+ * Get the current tick
+ */
+timer_wheel::tick_t timer_wheel::now() const {
+  return m_now;
+}
+
+/**
+ * Get the next tick at which the wheel needs to be advanced
+ *
+ * This is exact for timers due within the next 64 ticks and
+ * a lower bound for timers that still need to be cascaded.
+ * Returns the max tick value if the wheel is empty.
+ */
+timer_wheel::tick_t timer_wheel::next_expiry() const {
+  tick_t next{std::numeric_limits<tick_t>::max()};
+
+  if (m_occupied[0]) {
+    next = m_now + static_cast<tick_t>(__builtin_ctzll(rotate(m_occupied[0], m_now + 1))) + 1;
+  }
+
+  for (size_t level = 1; level < LEVELS; level++) {
+    if (!m_occupied[level]) {
+      continue;
+    }
+    size_t shift{SLOT_BITS * level};
+    tick_t block{(m_now >> shift) + 1};
+    block += static_cast<tick_t>(__builtin_ctzll(rotate(m_occupied[level], block)));
+    next = std::min(next, block << shift);
+  }
+
+  return next;
+}
+
+/**
+ * Get the number of scheduled timers
+ */
+size_t timer_wheel::size() const {
+  return m_entries.size();
+}
+
+/**
+ * Check if there are no scheduled timers
+ */
+bool timer_wheel::empty() const {
+  return m_entries.empty();
+}
+
+/**
+ * Put timer in the slot matching the distance to given tick
+ *
+ * Timers beyond the range of the wheel are parked in the
+ * furthest slot and placed again once it gets cascaded
+ */
+void timer_wheel::place(id_t id, entry& e, tick_t at) {
+  tick_t delta{at - m_now};
+  size_t level{0};
+
+  while (level + 1 < LEVELS && delta >= (tick_t{1} << (SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+
+  if (delta >= (tick_t{1} << (SLOT_BITS * LEVELS))) {
+    at = m_now + (tick_t{1} << (SLOT_BITS * LEVELS)) - 1;
+  }
+
+  e.level = level;
+  e.slot = (at >> (SLOT_BITS * level)) & (SLOTS - 1);
+
+  auto& slot = m_slots[e.level][e.slot];
+  e.pos = slot.insert(slot.end(), id);
+  m_occupied[e.level] |= uint64_t{1} << e.slot;
+}
+
+/**
+ * Take timer out of its slot
+ */
+void timer_wheel::unlink(entry& e) {
+  auto& slot = m_slots[e.level][e.slot];
+  slot.erase(e.pos);
+  if (slot.empty()) {
+    m_occupied[e.level] &= ~(uint64_t{1} << e.slot);
+  }
+}
+
+/**
+ * Move all timers of a slot down to the lower levels
+ */
+void timer_wheel::cascade(size_t level, size_t slot) {
+  std::list<id_t> ids;
+  ids.swap(m_slots[level][slot]);
+  m_occupied[level] &= ~(uint64_t{1} << slot);
+
+  for (auto&& id : ids) {
+    auto& e = m_entries.at(id);
+    place(id, e, std::max(e.expires, m_now));
+  }
+}
+
+/**
+ * Remove all timers of a level 0 slot
+ */
+void timer_wheel::expire(size_t slot, vector<id_t>& expired) {
+  std::list<id_t> ids;
+  ids.swap(m_slots[0][slot]);
+  m_occupied[0] &= ~(uint64_t{1} << slot);
+
+  for (auto&& id : ids) {
+    expired.emplace_back(id);
+    m_entries.erase(id);
+  }
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,154 @@
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include "errors.hpp"
+#include "utils/uevent.hpp"
+
+POLYBAR_NS
+
+/**
+ * Kernel name of the device, i.e. the last component of its path
+ */
+string uevent::name() const {
+  auto pos = devpath.rfind('/');
+  return pos == string::npos ? devpath : devpath.substr(pos + 1);
+}
+
+namespace uevent_util {
+  /**
+   * Parse a kernel uevent message
+   *
+   * The message starts with an "action@devpath" header followed by
+   * NUL separated KEY=value pairs. Messages re-broadcast by udev are
+   * prefixed with "libudev" and use a binary header, they are rejected.
+   */
+  bool parse(const char* data, size_t size, uevent& event) {
+    const char* end{data + size};
+    const char* header_end{static_cast<const char*>(memchr(data, '\0', size))};
+
+    if (header_end == nullptr || memchr(data, '@', header_end - data) == nullptr) {
+      return false;
+    }
+
+    event = uevent{};
+
+    for (const char* pos = header_end + 1; pos < end;) {
+      const char* entry_end{static_cast<const char*>(memchr(pos, '\0', end - pos))};
+      if (entry_end == nullptr) {
+        entry_end = end;
+      }
+
+      const char* separator{static_cast<const char*>(memchr(pos, '=', entry_end - pos))};
+
+      if (separator != nullptr) {
+        string key{pos, separator};
+        string value{separator + 1, entry_end};
+
+        if (key == "ACTION") {
+          event.action = move(value);
+        } else if (key == "DEVPATH") {
+          event.devpath = move(value);
+        } else if (key == "SUBSYSTEM") {
+          event.subsystem = move(value);
+        } else {
+          event.properties.emplace(move(key), move(value));
+        }
+      }
+
+      pos = entry_end + 1;
+    }
+
+    return !event.action.empty() && !event.devpath.empty();
+  }
+}
+
+/**
+ * Open a netlink socket listening for kernel uevents
+ */
+uevent_socket::uevent_socket(string subsystem)
+    : uevent_socket(move(subsystem), socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT)) {
+  struct sockaddr_nl addr {};
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = 1;
+
+  if (bind(m_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+    throw system_error("Failed to bind uevent socket");
+  }
+}
+
+/**
+ * Listen for uevents on an already connected socket
+ */
+uevent_socket::uevent_socket(string subsystem, int fd) : m_subsystem(move(subsystem)), m_fd(fd), m_buffer(8192) {
+  if (m_fd == -1) {
+    throw system_error("Failed to open uevent socket");
+  }
+}
+
+uevent_socket::~uevent_socket() {
+  if (m_fd != -1) {
+    close(m_fd);
+  }
+}
+
+int uevent_socket::get_file_descriptor() const {
+  return m_fd;
+}
+
+/**
+ * Wait for queued messages
+ *
+ * @brief A wait_ms of -1 blocks until a message arrives
+ */
+bool uevent_socket::poll(int wait_ms) const {
+  struct pollfd fds[1];
+  fds[0].fd = m_fd;
+  fds[0].events = POLLIN;
+
+  return ::poll(fds, 1, wait_ms) > 0 && (fds[0].revents & POLLIN);
+}
+
+/**
+ * Read all queued messages and pass the events of
+ * the subsystem to the callback
+ *
+ * Messages that don't come from the kernel are ignored
+ */
+size_t uevent_socket::read(const callback& fn) {
+  size_t count{0U};
+  uevent event;
+
+  while (true) {
+    struct sockaddr_storage addr {};
+    socklen_t addrlen{sizeof(addr)};
+
+    auto bytes = recvfrom(m_fd, m_buffer.data(), m_buffer.size(), MSG_DONTWAIT,
+        reinterpret_cast<struct sockaddr*>(&addr), &addrlen);
+
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    } else if (bytes <= 0) {
+      break;
+    }
+
+    if (addr.ss_family == AF_NETLINK && reinterpret_cast<struct sockaddr_nl*>(&addr)->nl_pid != 0) {
+      continue;
+    } else if (!uevent_util::parse(m_buffer.data(), bytes, event) || event.subsystem != m_subsystem) {
+      continue;
+    }
+
+    count++;
+
+    if (fn) {
+      fn(event);
+    }
+  }
+
+  return count;
+}
+
+POLYBAR_NS_END
@@ -63,6 +63,9 @@ void connection::query_extensions() {
 #if WITH_XCOMPOSITE
   composite_util::query_extension(*this);
 #endif
+#if WITH_XSHM
+  shm_util::query_extension(*this);
+#endif
 #if WITH_XKB
   xkb_util::query_extension(*this);
 #endif
@@ -17,6 +17,58 @@ namespace render_util {
       throw application_error("Missing X extension: Render");
     }
   }
+
+  /**
+   * Find the picture format with a single 8-bit alpha channel
+   */
+  xcb_render_pictformat_t find_alpha_format(connection& conn) {
+    xcb_render_pictformat_t result{XCB_NONE};
+    auto reply = xcb_render_query_pict_formats_reply(conn, xcb_render_query_pict_formats(conn), nullptr);
+
+    if (reply == nullptr) {
+      return result;
+    }
+
+    for (auto it = xcb_render_query_pict_formats_formats_iterator(reply); it.rem; xcb_render_pictforminfo_next(&it)) {
+      const auto& direct = it.data->direct;
+      if (it.data->type == XCB_RENDER_PICT_TYPE_DIRECT && it.data->depth == 8 && direct.alpha_mask == 0xff &&
+          !direct.red_mask && !direct.green_mask && !direct.blue_mask) {
+        result = it.data->id;
+        break;
+      }
+    }
+
+    free(reply);
+    return result;
+  }
+
+  /**
+   * Find the picture format matching given visual
+   */
+  xcb_render_pictformat_t find_visual_format(connection& conn, xcb_visualid_t visual) {
+    xcb_render_pictformat_t result{XCB_NONE};
+    auto reply = xcb_render_query_pict_formats_reply(conn, xcb_render_query_pict_formats(conn), nullptr);
+
+    if (reply == nullptr) {
+      return result;
+    }
+
+    for (auto screen = xcb_render_query_pict_formats_screens_iterator(reply); screen.rem && !result;
+         xcb_render_pictscreen_next(&screen)) {
+      for (auto depth = xcb_render_pictscreen_depths_iterator(screen.data); depth.rem && !result;
+           xcb_render_pictdepth_next(&depth)) {
+        for (auto it = xcb_render_pictdepth_visuals_iterator(depth.data); it.rem; xcb_render_pictvisual_next(&it)) {
+          if (it.data->visual == visual) {
+            result = it.data->format;
+            break;
+          }
+        }
+      }
+    }
+
+    free(reply);
+    return result;
+  }
 }
 
 POLYBAR_NS_END
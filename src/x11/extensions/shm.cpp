@@ -0,0 +1,27 @@
+#include "x11/extensions/shm.hpp"
+#include "x11/connection.hpp"
+
+POLYBAR_NS
+
+namespace shm_util {
+  /**
+   * Query for the MIT-SHM extension
+   *
+   * The extension is optional, surfaces are uploaded
+   * with regular PutImage requests when it is missing
+   */
+  void query_extension(connection& conn) {
+    if (has_extension(conn)) {
+      conn.shm().query_version();
+    }
+  }
+
+  /**
+   * Test if the server supports the MIT-SHM extension
+   */
+  bool has_extension(connection& conn) {
+    return conn.extension<xpp::shm::extension>()->present;
+  }
+}
+
+POLYBAR_NS_END
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <X11/Xlib-xcb.h>
 
 #include "components/logger.hpp"
@@ -7,14 +8,74 @@
 #include "utils/memory.hpp"
 #include "x11/connection.hpp"
 #include "x11/draw.hpp"
+#if WITH_XRENDER
+#include "x11/extensions/render.hpp"
+#endif
 #include "x11/fonts.hpp"
 #include "x11/xlib.hpp"
 #include "x11/xutils.hpp"
 
 POLYBAR_NS
 
+namespace {
+  /**
+   * FreeType settings matching the ones Xft derives
+   * from the fontconfig pattern of the font
+   */
+  struct raster_settings {
+    FT_Int32 load_flags{FT_LOAD_DEFAULT};
+    FT_Render_Mode render_mode{FT_RENDER_MODE_NORMAL};
+    bool embolden{false};
+    bool subpixel{false};
+  };
+
+  raster_settings get_raster_settings(FcPattern* pattern) {
+    FcBool antialias{FcTrue};
+    FcBool hinting{FcTrue};
+    FcBool autohint{FcFalse};
+    FcBool embolden{FcFalse};
+    FcBool bitmaps{FcTrue};
+    int hintstyle{FC_HINT_FULL};
+    int rgba{FC_RGBA_UNKNOWN};
+
+    FcPatternGetBool(pattern, FC_ANTIALIAS, 0, &antialias);
+    FcPatternGetBool(pattern, FC_HINTING, 0, &hinting);
+    FcPatternGetBool(pattern, FC_AUTOHINT, 0, &autohint);
+    FcPatternGetBool(pattern, FC_EMBOLDEN, 0, &embolden);
+    FcPatternGetBool(pattern, FC_EMBEDDED_BITMAP, 0, &bitmaps);
+    FcPatternGetInteger(pattern, FC_HINT_STYLE, 0, &hintstyle);
+    FcPatternGetInteger(pattern, FC_RGBA, 0, &rgba);
+
+    raster_settings settings{};
+    settings.embolden = embolden;
+    settings.subpixel = antialias && rgba != FC_RGBA_UNKNOWN && rgba != FC_RGBA_NONE;
+
+    if (!hinting || hintstyle == FC_HINT_NONE) {
+      settings.load_flags |= FT_LOAD_NO_HINTING;
+    }
+    if (!antialias) {
+      settings.load_flags |= FT_LOAD_TARGET_MONO;
+      settings.render_mode = FT_RENDER_MODE_MONO;
+    } else if (hinting && hintstyle == FC_HINT_SLIGHT) {
+      settings.load_flags |= FT_LOAD_TARGET_LIGHT;
+      settings.render_mode = FT_RENDER_MODE_LIGHT;
+    }
+    if (autohint) {
+      settings.load_flags |= FT_LOAD_FORCE_AUTOHINT;
+    }
+    if (antialias && !bitmaps) {
+      settings.load_flags |= FT_LOAD_NO_BITMAP;
+    }
+
+    return settings;
+  }
+}
+
 void font_ref::_deleter::operator()(font_ref* font) {
-  font->glyph_widths.clear();
+  font->glyph_advances.clear();
+  font->runs.clear();
+  font->prevruns.clear();
+  font->bitmaps.clear();
   font->width_lut.clear();
 
   if (font->xft != nullptr) {
@@ -23,6 +84,11 @@ void font_ref::_deleter::operator()(font_ref* font) {
   if (font->ptr != XCB_NONE) {
     xcb_close_font(&*xutils::get_connection(), font->ptr);
   }
+#if WITH_XRENDER
+  if (font->glyphset != XCB_NONE) {
+    xcb_render_free_glyph_set(&*xutils::get_connection(), font->glyphset);
+  }
+#endif
   delete font;
 }
 
@@ -43,10 +109,22 @@ font_manager::font_manager(connection& conn, const logger& logger, Display* dsp,
   if (!XftInit(nullptr) || !XftInitFtLibrary()) {
     throw application_error("Could not initialize Xft library");
   }
+#if WITH_XRENDER
+  m_alphaformat = render_util::find_alpha_format(m_connection);
+  m_targetformat = render_util::find_visual_format(m_connection, XVisualIDFromVisual(m_visual));
+#endif
 }
 
 font_manager::~font_manager() {
   cleanup();
+#if WITH_XRENDER
+  if (m_target != XCB_NONE) {
+    xcb_render_free_picture(m_connection, m_target);
+  }
+  if (m_fill != XCB_NONE) {
+    xcb_render_free_picture(m_connection, m_fill);
+  }
+#endif
   if (m_display) {
     if (m_xftcolor_allocated) {
       XftColorFree(m_display, m_visual, m_colormap, &m_xftcolor);
@@ -57,6 +135,9 @@ font_manager::~font_manager() {
 
 void font_manager::set_visual(Visual* v) {
   m_visual = v;
+#if WITH_XRENDER
+  m_targetformat = render_util::find_visual_format(m_connection, XVisualIDFromVisual(m_visual));
+#endif
 }
 
 void font_manager::cleanup() {
@@ -109,6 +190,7 @@ bool font_manager::load(const string& name, uint8_t fontindex, int8_t offset_y)
   }
 
   m_fonts.emplace(make_pair(fontindex, move(font)));
+  m_chartables.clear();
 
   int max_height{0};
 
@@ -136,7 +218,41 @@ void font_manager::fontindex(uint8_t index) {
   }
 }
 
-shared_ptr<font_ref> font_manager::match_char(const uint16_t chr) {
+/**
+ * Get the font used for given character
+ *
+ * Matches are cached in a two-level table of 256 codepoint pages
+ * for each preferred font index. The page index grows up to the
+ * highest codepoint seen, pages are filled on first use and dropped
+ * whenever another font is loaded
+ */
+shared_ptr<font_ref> font_manager::match_char(const uint32_t chr) {
+  auto& table = m_chartables[m_fontindex];
+
+  if (chr >> 8 >= table.size()) {
+    table.resize((chr >> 8) + 1);
+  }
+
+  auto& page = table[chr >> 8];
+
+  if (!page) {
+    page.reset(new char_page{});
+  }
+
+  auto& entry = (*page)[chr & 0xFF];
+
+  if (entry == nullptr) {
+    entry = &find_char(chr);
+  }
+
+  return *entry;
+}
+
+/**
+ * Search the loaded fonts for one that contains given character,
+ * starting with the preferred font
+ */
+const shared_ptr<font_ref>& font_manager::find_char(const uint32_t chr) {
   if (!m_fonts.empty()) {
     if (m_fontindex > 0 && static_cast<size_t>(m_fontindex) <= m_fonts.size()) {
       auto iter = m_fonts.find(m_fontindex);
@@ -157,32 +273,78 @@ shared_ptr<font_ref> font_manager::match_char(const uint16_t chr) {
     }
   }
 
-  return {};
+  return m_nomatch;
 }
 
-uint8_t font_manager::glyph_width(const shared_ptr<font_ref>& font, const uint16_t chr) {
-  if (font && font->xft != nullptr) {
-    return glyph_width_xft(move(font), chr);
-  } else if (font && font->ptr != XCB_NONE) {
-    return glyph_width_xcb(move(font), chr);
-  } else {
-    return 0;
+/**
+ * Get the glyphs and advances of a run of characters drawn with given font
+ *
+ * Runs are cached per font in two generations. Once the current generation
+ * is full it replaces the previous one, and runs that are still in use get
+ * moved back into the current generation on their next lookup
+ */
+const text_run& font_manager::measure(const shared_ptr<font_ref>& font, const uint32_t* chars, size_t len) {
+  std::u32string key(reinterpret_cast<const char32_t*>(chars), len);
+
+  auto it = font->runs.find(key);
+  if (it != font->runs.end()) {
+    return it->second;
+  }
+
+  if (font->runs.size() >= TEXT_RUN_CACHE_SIZE) {
+    font->prevruns = move(font->runs);
+    font->runs.clear();
   }
+
+  auto prev = font->prevruns.find(key);
+  if (prev != font->prevruns.end()) {
+    text_run run{move(prev->second)};
+    font->prevruns.erase(prev);
+    return font->runs.emplace(move(key), move(run)).first->second;
+  }
+
+  text_run run{};
+  run.glyphs.resize(len);
+  run.advances.resize(len);
+
+  if (font->xft != nullptr) {
+    measure_xft(font, chars, run);
+  } else if (font->ptr != XCB_NONE) {
+    measure_xcb(font, chars, run);
+  }
+
+  for (auto&& advance : run.advances) {
+    run.width += advance;
+  }
+
+  return font->runs.emplace(move(key), move(run)).first->second;
 }
 
 void font_manager::drawtext(const shared_ptr<font_ref>& font, xcb_pixmap_t pm, xcb_gcontext_t gc, int16_t x, int16_t y,
-    const uint16_t* chars, size_t num_chars) {
+    const uint32_t* chars, size_t num_chars) {
+#if WITH_XRENDER
+  if (font->xft != nullptr && render_glyphs(font, pm, x, y, measure(font, chars, num_chars).glyphs)) {
+    return;
+  }
+#endif
   if (m_xftdraw == nullptr) {
     m_xftdraw = XftDrawCreate(m_display, pm, m_visual, m_colormap);
   }
   if (font->xft != nullptr) {
-    XftDrawString16(m_xftdraw, &m_xftcolor, font->xft, x, y, chars, num_chars);
+    XftDrawString32(m_xftdraw, &m_xftcolor, font->xft, x, y, chars, num_chars);
   } else if (font->ptr != XCB_NONE) {
     vector<uint16_t> ucs(num_chars);
     for (size_t i = 0; i < num_chars; i++) {
-      ucs[i] = (chars[i] >> 8) | (chars[i] << 8);
+      ucs[i] = static_cast<uint16_t>(((chars[i] >> 8) & 0xff) | ((chars[i] & 0xff) << 8));
+    }
+    // A single text item holds at most 254 characters
+    for (size_t i = 0; i < num_chars; i += 254) {
+      auto len = static_cast<uint8_t>(std::min<size_t>(num_chars - i, 254));
+      xcb_poly_text_16(pm, gc, x, y, len, ucs.data() + i);
+      for (size_t n = i; n < i + len; n++) {
+        x += glyph_width_xcb(font, chars[n]);
+      }
     }
-    xcb_poly_text_16(pm, gc, x, y, num_chars, ucs.data());
   }
 }
 
@@ -205,6 +367,19 @@ void font_manager::allocate_color(XRenderColor color) {
   if (!(m_xftcolor_allocated = XftColorAllocValue(m_display, m_visual, m_colormap, &color, &m_xftcolor))) {
     m_logger.err("Failed to allocate color");
   }
+
+#if WITH_XRENDER
+  // The components are already premultiplied by the parser,
+  // pass them on unchanged like Xft does
+  xcb_render_color_t fill{color.red, color.green, color.blue, color.alpha};
+
+  if (m_fill != XCB_NONE) {
+    xcb_render_free_picture(m_connection, m_fill);
+  }
+
+  m_fill = m_connection.generate_id();
+  xcb_render_create_solid_fill(m_connection, m_fill, fill);
+#endif
 }
 
 bool font_manager::open_xcb_font(const shared_ptr<font_ref>& font, string fontname) {
@@ -239,25 +414,47 @@ bool font_manager::open_xcb_font(const shared_ptr<font_ref>& font, string fontna
   return false;
 }
 
-uint8_t font_manager::glyph_width_xft(const shared_ptr<font_ref>& font, const uint16_t chr) {
-  auto it = font->glyph_widths.find(chr);
-  if (it != font->glyph_widths.end()) {
-    return it->second;
+/**
+ * Resolve glyph indices and advances using Xft,
+ * glyphs without a known advance are loaded in one batch
+ */
+void font_manager::measure_xft(const shared_ptr<font_ref>& font, const uint32_t* chars, text_run& run) {
+  vector<FT_UInt> missing;
+
+  for (size_t i = 0; i < run.glyphs.size(); i++) {
+    run.glyphs[i] = XftCharIndex(m_display, font->xft, static_cast<FcChar32>(chars[i]));
+
+    if (font->glyph_advances.emplace(run.glyphs[i], 0U).second) {
+      missing.emplace_back(run.glyphs[i]);
+    }
   }
 
-  XGlyphInfo extents{};
-  FT_UInt glyph{XftCharIndex(m_display, font->xft, static_cast<FcChar32>(chr))};
+  if (!missing.empty()) {
+    XftFontLoadGlyphs(m_display, font->xft, FcFalse, missing.data(), missing.size());
 
-  XftFontLoadGlyphs(m_display, font->xft, FcFalse, &glyph, 1);
-  XftGlyphExtents(m_display, font->xft, &glyph, 1, &extents);
-  XftFontUnloadGlyphs(m_display, font->xft, &glyph, 1);
+    for (auto&& glyph : missing) {
+      XGlyphInfo extents{};
+      XftGlyphExtents(m_display, font->xft, &glyph, 1, &extents);
+      font->glyph_advances[glyph] = extents.xOff;
+    }
+  }
 
-  font->glyph_widths.emplace_hint(it, chr, extents.xOff);  //.emplace_back(chr, extents.xOff);
+  for (size_t i = 0; i < run.glyphs.size(); i++) {
+    run.advances[i] = font->glyph_advances[run.glyphs[i]];
+  }
+}
 
-  return extents.xOff;
+/**
+ * Use the character codes and the width table of the X core font
+ */
+void font_manager::measure_xcb(const shared_ptr<font_ref>& font, const uint32_t* chars, text_run& run) {
+  for (size_t i = 0; i < run.glyphs.size(); i++) {
+    run.glyphs[i] = chars[i];
+    run.advances[i] = glyph_width_xcb(font, chars[i]);
+  }
 }
 
-uint8_t font_manager::glyph_width_xcb(const shared_ptr<font_ref>& font, const uint16_t chr) {
+uint16_t font_manager::glyph_width_xcb(const shared_ptr<font_ref>& font, const uint32_t chr) {
   if (!font || font->ptr == XCB_NONE) {
     return 0;
   } else if (static_cast<size_t>(chr - font->char_min) < font->width_lut.size()) {
@@ -267,7 +464,7 @@ uint8_t font_manager::glyph_width_xcb(const shared_ptr<font_ref>& font, const ui
   }
 }
 
-bool font_manager::has_glyph_xft(const shared_ptr<font_ref>& font, const uint16_t chr) {
+bool font_manager::has_glyph_xft(const shared_ptr<font_ref>& font, const uint32_t chr) {
   if (!font || font->xft == nullptr) {
     return false;
   } else if (XftCharExists(m_display, font->xft, static_cast<FcChar32>(chr)) == FcFalse) {
@@ -277,7 +474,7 @@ bool font_manager::has_glyph_xft(const shared_ptr<font_ref>& font, const uint16_
   }
 }
 
-bool font_manager::has_glyph_xcb(const shared_ptr<font_ref>& font, const uint16_t chr) {
+bool font_manager::has_glyph_xcb(const shared_ptr<font_ref>& font, const uint32_t chr) {
   if (font->ptr == XCB_NONE) {
     return false;
   } else if (chr < font->char_min || chr > font->char_max) {
@@ -291,6 +488,194 @@ bool font_manager::has_glyph_xcb(const shared_ptr<font_ref>& font, const uint16_
   }
 }
 
+/**
+ * Get the coverage mask of a glyph, rasterized with FreeType on first use
+ *
+ * The glyph is loaded with the antialiasing, hinting and emboldening
+ * settings of the font's pattern, so that it looks the same as when
+ * drawn by Xft. Returns nullptr for glyphs that are not plain coverage
+ * masks, e.g. the color bitmaps of emoji fonts or subpixel rendering
+ */
+const glyph_bitmap* font_manager::rasterize(const shared_ptr<font_ref>& font, FT_UInt glyph) {
+  if (!font || font->xft == nullptr) {
+    return nullptr;
+  }
+
+  auto it = font->bitmaps.find(glyph);
+  if (it != font->bitmaps.end()) {
+    return it->second.get();
+  }
+
+  const raster_settings settings{get_raster_settings(font->xft->pattern)};
+
+  if (settings.subpixel) {
+    return font->bitmaps.emplace(glyph, nullptr).first->second.get();
+  }
+
+  unique_ptr<glyph_bitmap> result;
+  FT_Face face{XftLockFace(font->xft)};
+  FT_GlyphSlot slot{nullptr};
+
+  if (face != nullptr && FT_Load_Glyph(face, glyph, settings.load_flags) == 0) {
+    slot = face->glyph;
+
+    if (settings.embolden && slot->format == FT_GLYPH_FORMAT_OUTLINE) {
+      FT_GlyphSlot_Embolden(slot);
+    }
+    if (slot->format != FT_GLYPH_FORMAT_BITMAP && FT_Render_Glyph(slot, settings.render_mode) != 0) {
+      slot = nullptr;
+    }
+  }
+
+  if (slot != nullptr) {
+    const FT_Bitmap& bitmap{slot->bitmap};
+
+    if (bitmap.pixel_mode == FT_PIXEL_MODE_GRAY || bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
+      result = make_unique<glyph_bitmap>();
+      result->width = bitmap.width;
+      result->rows = bitmap.rows;
+      result->left = slot->bitmap_left;
+      result->top = slot->bitmap_top;
+      result->advance = (slot->advance.x + 32) >> 6;
+      result->coverage.resize(bitmap.width * bitmap.rows);
+
+      for (size_t row = 0; row < bitmap.rows; row++) {
+        const uint8_t* src{bitmap.buffer + row * bitmap.pitch};
+        uint8_t* dst{result->coverage.data() + row * bitmap.width};
+
+        for (size_t col = 0; col < bitmap.width; col++) {
+          if (bitmap.pixel_mode == FT_PIXEL_MODE_GRAY) {
+            dst[col] = src[col];
+          } else if ((src[col / 8] >> (7 - col % 8)) & 1) {
+            dst[col] = 0xFF;
+          }
+        }
+      }
+    }
+  }
+
+  if (face != nullptr) {
+    XftUnlockFace(font->xft);
+  }
+
+  return font->bitmaps.emplace(glyph, move(result)).first->second.get();
+}
+
+#if WITH_XRENDER
+/**
+ * Draw text using the glyph set of the font
+ *
+ * Takes the glyph ids of the measured run. Glyphs are rasterized and
+ * uploaded the first time they are used, after that each draw only
+ * sends the glyph ids
+ */
+bool font_manager::render_glyphs(
+    const shared_ptr<font_ref>& font, xcb_pixmap_t pm, int16_t x, int16_t y, const vector<FT_UInt>& glyphs) {
+  static_assert(sizeof(FT_UInt) == sizeof(uint32_t), "glyph ids are sent as 32-bit values");
+
+  if (!font->glyphset_usable || m_alphaformat == XCB_NONE || m_targetformat == XCB_NONE || m_fill == XCB_NONE) {
+    return false;
+  }
+
+  if (!upload_glyphs(font, glyphs)) {
+    m_logger.trace("font_manager: Glyph set not usable for font, falling back to Xft");
+    font->glyphset_usable = false;
+    return false;
+  }
+
+  if (m_targetpixmap != pm) {
+    if (m_target != XCB_NONE) {
+      xcb_render_free_picture(m_connection, m_target);
+    }
+    m_target = m_connection.generate_id();
+    m_targetpixmap = pm;
+    xcb_render_create_picture(m_connection, m_target, pm, m_targetformat, 0, nullptr);
+  }
+
+  // A glyph list item holds at most 254 glyphs, the
+  // following items continue at the current pen position
+  vector<uint8_t> cmds;
+  cmds.reserve(glyphs.size() * sizeof(uint32_t) + (glyphs.size() / 254 + 1) * sizeof(render_util::glyph_elt));
+
+  for (size_t i = 0; i < glyphs.size(); i += 254) {
+    render_util::glyph_elt elt{};
+    elt.len = static_cast<uint8_t>(std::min<size_t>(glyphs.size() - i, 254));
+    elt.deltax = i ? 0 : x;
+    elt.deltay = i ? 0 : y;
+
+    const auto* header = reinterpret_cast<const uint8_t*>(&elt);
+    cmds.insert(cmds.end(), header, header + sizeof(elt));
+
+    const auto* ids = reinterpret_cast<const uint8_t*>(glyphs.data() + i);
+    cmds.insert(cmds.end(), ids, ids + elt.len * sizeof(uint32_t));
+  }
+
+  xcb_render_composite_glyphs_32(m_connection, XCB_RENDER_PICT_OP_OVER, m_fill, m_target, m_alphaformat,
+      font->glyphset, 0, 0, cmds.size(), cmds.data());
+
+  return true;
+}
+
+/**
+ * Rasterize the glyphs that are missing from the glyph set
+ * of the font and upload them with a single request
+ */
+bool font_manager::upload_glyphs(const shared_ptr<font_ref>& font, const vector<FT_UInt>& glyphs) {
+  if (font->glyphset == XCB_NONE) {
+    font->glyphset = m_connection.generate_id();
+    xcb_render_create_glyph_set(m_connection, font->glyphset, m_alphaformat);
+  }
+
+  vector<uint32_t> ids;
+  vector<xcb_render_glyphinfo_t> infos;
+  vector<uint8_t> data;
+
+  for (auto&& glyph : glyphs) {
+    if (font->glyphset_loaded.find(glyph) == font->glyphset_loaded.end() &&
+        std::find(ids.begin(), ids.end(), glyph) == ids.end()) {
+      ids.emplace_back(glyph);
+    }
+  }
+
+  if (ids.empty()) {
+    return true;
+  }
+
+  for (auto&& glyph : ids) {
+    const glyph_bitmap* bitmap{rasterize(font, glyph)};
+
+    // Only coverage masks fit in an alpha glyph set
+    if (bitmap == nullptr) {
+      return false;
+    }
+
+    auto advance = font->glyph_advances.find(glyph);
+
+    xcb_render_glyphinfo_t info{};
+    info.width = bitmap->width;
+    info.height = bitmap->rows;
+    info.x = -bitmap->left;
+    info.y = bitmap->top;
+    info.x_off = advance != font->glyph_advances.end() ? advance->second : bitmap->advance;
+    infos.emplace_back(info);
+
+    // Rows are padded to 32 bits
+    size_t stride{(bitmap->width + 3U) & ~3U};
+
+    for (size_t row = 0; row < bitmap->rows; row++) {
+      const auto* src = bitmap->coverage.data() + row * bitmap->width;
+      data.insert(data.end(), src, src + bitmap->width);
+      data.resize(data.size() + stride - bitmap->width, 0);
+    }
+  }
+
+  xcb_render_add_glyphs(m_connection, font->glyphset, ids.size(), ids.data(), infos.data(), data.size(), data.data());
+  font->glyphset_loaded.insert(ids.begin(), ids.end());
+
+  return true;
+}
+#endif
+
 void font_manager::xcb_poly_text_16(
     xcb_drawable_t d, xcb_gcontext_t gc, int16_t x, int16_t y, uint8_t len, uint16_t* str) {
   static const xcb_protocol_request_t xcb_req = {5, nullptr, XCB_POLY_TEXT_16, 1};
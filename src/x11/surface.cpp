@@ -0,0 +1,270 @@
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "x11/connection.hpp"
+#include "x11/surface.hpp"
+#if WITH_XSHM
+#include "x11/extensions/shm.hpp"
+#endif
+
+POLYBAR_NS
+
+namespace {
+  /**
+   * Multiply 8-bit values and divide by 255 with correct rounding
+   */
+  inline uint32_t mul_div255(uint32_t a, uint32_t b) {
+    uint32_t t{a * b + 128};
+    return (t + (t >> 8)) >> 8;
+  }
+
+  void fill_row(uint32_t* dst, size_t n, uint32_t color) {
+    size_t i{0};
+#ifdef __SSE2__
+    const __m128i src{_mm_set1_epi32(static_cast<int>(color))};
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), src);
+    }
+#endif
+    for (; i < n; i++) {
+      dst[i] = color;
+    }
+  }
+
+  /**
+   * Composite a premultiplied color over the row, scaled by the coverage mask
+   */
+  void blend_row(uint32_t* dst, const uint8_t* mask, size_t n, uint32_t color) {
+    size_t i{0};
+#ifdef __SSE2__
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i half{_mm_set1_epi16(128)};
+    const __m128i full{_mm_set1_epi16(255)};
+    const __m128i src{_mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero)};
+
+    const auto div255 = [&](__m128i v) {
+      v = _mm_add_epi16(v, half);
+      return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+    };
+
+    for (; i + 4 <= n; i += 4) {
+      uint32_t coverage;
+      std::memcpy(&coverage, mask + i, sizeof(coverage));
+
+      if (!coverage) {
+        continue;
+      }
+
+      // Spread each coverage byte over the four channels of its pixel
+      __m128i m{_mm_cvtsi32_si128(static_cast<int>(coverage))};
+      m = _mm_unpacklo_epi8(m, m);
+      m = _mm_unpacklo_epi16(m, m);
+
+      __m128i d{_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i))};
+      __m128i result[2];
+
+      for (int half_index = 0; half_index < 2; half_index++) {
+        __m128i cov{half_index ? _mm_unpackhi_epi8(m, zero) : _mm_unpacklo_epi8(m, zero)};
+        __m128i pixels{half_index ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero)};
+        __m128i s{div255(_mm_mullo_epi16(src, cov))};
+        __m128i alpha{_mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3))};
+        result[half_index] = _mm_add_epi16(s, div255(_mm_mullo_epi16(pixels, _mm_sub_epi16(full, alpha))));
+      }
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(result[0], result[1]));
+    }
+#endif
+    for (; i < n; i++) {
+      if (!mask[i]) {
+        continue;
+      }
+
+      uint32_t s{0};
+      uint32_t d{dst[i]};
+      uint32_t alpha{mul_div255(color >> 24, mask[i])};
+
+      for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t channel{mul_div255((color >> shift) & 0xFF, mask[i])};
+        channel += mul_div255((d >> shift) & 0xFF, 255 - alpha);
+        s |= std::min(channel, 255U) << shift;
+      }
+
+      dst[i] = s;
+    }
+  }
+}
+
+surface::surface(connection& conn, uint8_t depth, uint16_t w, uint16_t h)
+    : m_connection(conn), m_depth(depth), m_width(w), m_height(h) {
+#if WITH_XSHM
+  m_shared = shm_util::has_extension(conn);
+#endif
+  allocate();
+}
+
+surface::~surface() {
+  release();
+}
+
+uint16_t surface::width() const {
+  return m_width;
+}
+
+uint16_t surface::height() const {
+  return m_height;
+}
+
+void surface::resize(uint16_t w, uint16_t h) {
+  if (w != m_width || h != m_height) {
+    release();
+    m_width = w;
+    m_height = h;
+    allocate();
+  }
+}
+
+/**
+ * Replace the pixels of given area with the color
+ */
+void surface::fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint32_t color) {
+  int x1{std::max<int>(x, 0)}, x2{std::min<int>(x + w, m_width)};
+  int y1{std::max<int>(y, 0)}, y2{std::min<int>(y + h, m_height)};
+
+  if (x1 >= x2 || y1 >= y2) {
+    return;
+  }
+
+  sync();
+
+  for (int row = y1; row < y2; row++) {
+    fill_row(m_data + row * m_width + x1, x2 - x1, color);
+  }
+}
+
+/**
+ * Composite the color over given area using a coverage mask of w * h bytes
+ */
+void surface::blend(int16_t x, int16_t y, const uint8_t* mask, uint16_t w, uint16_t h, uint32_t color) {
+  int x1{std::max<int>(x, 0)}, x2{std::min<int>(x + w, m_width)};
+  int y1{std::max<int>(y, 0)}, y2{std::min<int>(y + h, m_height)};
+
+  if (x1 >= x2 || y1 >= y2) {
+    return;
+  }
+
+  sync();
+
+  for (int row = y1; row < y2; row++) {
+    blend_row(m_data + row * m_width + x1, mask + (row - y) * w + (x1 - x), x2 - x1, color);
+  }
+}
+
+/**
+ * Copy the columns of given span onto the drawable
+ */
+void surface::upload(xcb_drawable_t dst, xcb_gcontext_t gc, int16_t x, uint16_t w) {
+  int x1{std::max<int>(x, 0)}, x2{std::min<int>(x + w, m_width)};
+
+  if (x1 >= x2 || !m_height) {
+    return;
+  }
+
+  uint16_t width(x2 - x1);
+
+#if WITH_XSHM
+  if (m_segment != XCB_NONE) {
+    xcb_shm_put_image(m_connection, dst, gc, m_width, m_height, x1, 0, width, m_height, x1, 0, m_depth,
+        XCB_IMAGE_FORMAT_Z_PIXMAP, false, m_segment, 0);
+    m_pending = true;
+    return;
+  }
+#endif
+
+  // Send as many rows per request as the maximum request length allows
+  size_t max_bytes{xcb_get_maximum_request_length(m_connection) * 4U - sizeof(xcb_put_image_request_t)};
+  size_t rows_per_request{std::max<size_t>(max_bytes / (width * 4U), 1U)};
+  vector<uint32_t> rows;
+
+  for (size_t y = 0; y < m_height; y += rows_per_request) {
+    size_t count{std::min<size_t>(rows_per_request, m_height - y)};
+    rows.resize(count * width);
+
+    for (size_t row = 0; row < count; row++) {
+      const uint32_t* src{m_data + (y + row) * m_width + x1};
+      std::copy(src, src + width, rows.begin() + row * width);
+    }
+
+    xcb_put_image(m_connection, XCB_IMAGE_FORMAT_Z_PIXMAP, dst, gc, width, count, x1, y, 0, m_depth,
+        rows.size() * sizeof(uint32_t), reinterpret_cast<const uint8_t*>(rows.data()));
+  }
+}
+
+void surface::allocate() {
+  size_t size{static_cast<size_t>(m_width) * m_height};
+
+#if WITH_XSHM
+  if (m_shared && size) {
+    int id{shmget(IPC_PRIVATE, size * sizeof(uint32_t), IPC_CREAT | 0600)};
+    void* addr{id != -1 ? shmat(id, nullptr, 0) : reinterpret_cast<void*>(-1)};
+
+    if (addr != reinterpret_cast<void*>(-1)) {
+      m_segment = m_connection.generate_id();
+      auto cookie = xcb_shm_attach_checked(m_connection, m_segment, id, false);
+      auto error = xcb_request_check(m_connection, cookie);
+
+      if (error == nullptr) {
+        // Mark the segment for removal once both sides have detached
+        shmctl(id, IPC_RMID, nullptr);
+        m_data = static_cast<uint32_t*>(addr);
+        return;
+      }
+
+      free(error);
+      shmdt(addr);
+      m_segment = XCB_NONE;
+    }
+
+    if (id != -1) {
+      shmctl(id, IPC_RMID, nullptr);
+    }
+
+    // The server cannot access our memory, e.g. when running remotely
+    m_shared = false;
+  }
+#endif
+
+  m_buffer.assign(size, 0U);
+  m_data = m_buffer.data();
+}
+
+void surface::release() {
+#if WITH_XSHM
+  if (m_segment != XCB_NONE) {
+    sync();
+    xcb_shm_detach(m_connection, m_segment);
+    shmdt(m_data);
+    m_segment = XCB_NONE;
+  }
+#endif
+  m_buffer.clear();
+  m_data = nullptr;
+}
+
+/**
+ * Wait until the server has read the shared memory
+ * before the contents get modified again
+ */
+void surface::sync() {
+  if (m_pending) {
+    free(xcb_get_input_focus_reply(m_connection, xcb_get_input_focus(m_connection), nullptr));
+    m_pending = false;
+  }
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,315 @@
+#include <chrono>
+#include <cstdio>
+
+#include "components/drawlist.cpp"
+#include "components/parser.cpp"
+#include "utils/factory.cpp"
+#include "utils/string.cpp"
+
+using namespace polybar;
+
+namespace legacy {
+  /**
+   * Frozen copy of the parser before the single pass rewrite, which
+   * erased the handled prefix and copied the remaining input with
+   * substr for every tag and text run. Text is decoded into 32-bit
+   * codepoints so that both produce the same draw list.
+   */
+  class parser {
+   public:
+    void compile(const bar_settings& bar, string data, drawlist& output) {
+      m_actions.clear();
+
+      while (!data.empty()) {
+        size_t pos{string::npos};
+
+        if (data.compare(0, 2, "%{") == 0 && (pos = data.find('}')) != string::npos) {
+          codeblock(data.substr(2, pos - 2), bar, output);
+          data.erase(0, pos + 1);
+        } else if ((pos = data.find("%{")) != string::npos) {
+          data.erase(0, text(data.substr(0, pos), output));
+        } else {
+          data.erase(0, text(data.substr(0), output));
+        }
+      }
+
+      if (!m_actions.empty()) {
+        throw unclosed_actionblocks(to_string(m_actions.size()) + " unclosed action block(s)");
+      }
+    }
+
+   protected:
+    void codeblock(string&& data, const bar_settings& bar, drawlist& output) {
+      size_t pos;
+
+      while (data.length()) {
+        data = string_util::ltrim(move(data), ' ');
+
+        if (data.empty()) {
+          break;
+        }
+
+        char tag{data[0]};
+        string value;
+
+        data.erase(0, 1);
+
+        if ((pos = data.find_first_of(" }")) != string::npos) {
+          value = data.substr(0, pos);
+        } else {
+          value = data;
+        }
+
+        switch (tag) {
+          case 'B':
+            output.background(parse_color(value, bar.background));
+            break;
+          case 'F':
+            output.foreground(parse_color(value, bar.foreground));
+            break;
+          case 'T':
+            output.font(parse_fontindex(value));
+            break;
+          case 'U':
+            output.underline(parse_color(value, bar.underline.color));
+            output.overline(parse_color(value, bar.overline.color));
+            break;
+          case 'u':
+            output.underline(parse_color(value, bar.underline.color));
+            break;
+          case 'o':
+            output.overline(parse_color(value, bar.overline.color));
+            break;
+          case 'R':
+            output.background(parse_color(value, bar.foreground));
+            output.foreground(parse_color(value, bar.background));
+            break;
+          case 'O':
+            output.offset(static_cast<int16_t>(std::atoi(value.c_str())));
+            break;
+          case 'l':
+            output.align(alignment::LEFT);
+            break;
+          case 'c':
+            output.align(alignment::CENTER);
+            break;
+          case 'r':
+            output.align(alignment::RIGHT);
+            break;
+          case '+':
+            output.attribute_set(parse_attr(value[0]));
+            break;
+          case '-':
+            output.attribute_unset(parse_attr(value[0]));
+            break;
+          case '!':
+            output.attribute_toggle(parse_attr(value[0]));
+            break;
+          case 'A':
+            if (isdigit(data[0]) || data[0] == ':') {
+              value = parse_action_cmd(data.substr(data[0] != ':' ? 1 : 0));
+              mousebtn btn = parse_action_btn(data);
+              m_actions.push_back(static_cast<int>(btn));
+              output.action_begin(btn, value);
+
+              if (value[0] != ':') {
+                value += "0";
+              }
+              value += "::";
+            } else if (!m_actions.empty()) {
+              output.action_end(parse_action_btn(value));
+              m_actions.pop_back();
+            }
+            break;
+          default:
+            throw unrecognized_token("Unrecognized token '" + string{tag} + "'");
+        }
+
+        if (!data.empty()) {
+          data.erase(0, !value.empty() ? value.length() : 1);
+        }
+      }
+    }
+
+    size_t text(string&& data, drawlist& output) {
+      const uint8_t* utf{reinterpret_cast<const uint8_t*>(&data[0])};
+      uint32_t chr{0};
+      size_t len{1};
+
+      if (utf[0] < 0x80) {
+        size_t pos{0};
+        uint32_t buf[128];
+
+        while (utf[pos] && utf[pos] < 0x80) {
+          size_t count{0};
+
+          while (count < memory_util::countof(buf) && utf[pos] && utf[pos] < 0x80) {
+            buf[count++] = utf[pos++];
+          }
+
+          output.text(buf, count);
+        }
+
+        if (pos > 0) {
+          return pos;
+        }
+
+        chr = utf[0];
+      } else if ((utf[0] & 0xe0) == 0xc0) {
+        chr = ((utf[0] & 0x1f) << 6) | (utf[1] & 0x3f);
+        len = 2;
+      } else if ((utf[0] & 0xf0) == 0xe0) {
+        chr = ((utf[0] & 0x0f) << 12) | ((utf[1] & 0x3f) << 6) | (utf[2] & 0x3f);
+        len = 3;
+      } else if ((utf[0] & 0xf8) == 0xf0) {
+        chr = ((utf[0] & 0x07) << 18) | ((utf[1] & 0x3f) << 12) | ((utf[2] & 0x3f) << 6) | (utf[3] & 0x3f);
+        len = 4;
+      } else {
+        return 1;
+      }
+
+      output.text(&chr, 1);
+
+      return len;
+    }
+
+    uint32_t parse_color(const string& s, uint32_t fallback) {
+      uint32_t color{0};
+      if (s.empty() || s[0] == '-' || (color = color_util::parse(s, fallback)) == fallback) {
+        return fallback;
+      }
+      return color_util::premultiply_alpha(color);
+    }
+
+    uint8_t parse_fontindex(const string& s) {
+      if (s.empty() || s[0] == '-') {
+        return 0;
+      }
+
+      try {
+        return std::stoul(s, nullptr, 10);
+      } catch (const std::invalid_argument& err) {
+        return 0;
+      }
+    }
+
+    attribute parse_attr(const char attr) {
+      switch (attr) {
+        case 'o':
+          return attribute::OVERLINE;
+        case 'u':
+          return attribute::UNDERLINE;
+        default:
+          throw unrecognized_token("Unrecognized attribute '" + string{attr} + "'");
+      }
+    }
+
+    mousebtn parse_action_btn(const string& data) {
+      if (data[0] == ':') {
+        return mousebtn::LEFT;
+      } else if (isdigit(data[0])) {
+        return static_cast<mousebtn>(data[0] - '0');
+      } else if (!m_actions.empty()) {
+        return static_cast<mousebtn>(m_actions.back());
+      } else {
+        return mousebtn::NONE;
+      }
+    }
+
+    string parse_action_cmd(string&& data) {
+      if (data[0] != ':') {
+        return "";
+      }
+
+      size_t end{1};
+      while ((end = data.find(':', end)) != string::npos && data[end - 1] == '\\') {
+        end++;
+      }
+
+      if (end == string::npos) {
+        return "";
+      }
+
+      return data.substr(1, end - 1);
+    }
+
+   private:
+    vector<int> m_actions;
+  };
+}
+
+/**
+ * Generate the contents of a bspwm style bar: ten workspaces
+ * with a click and a scroll action each, colored and underlined
+ * depending on their state, repeated the given number of times
+ */
+string generate(size_t repeat) {
+  string data;
+
+  for (size_t r = 0; r < repeat; r++) {
+    data += "%{l}%{B#ff222222}%{A4:bspc desktop -f prev:}%{A5:bspc desktop -f next:}";
+
+    for (size_t i = 1; i <= 10; i++) {
+      auto n = to_string(i);
+      data += "%{A1:bspc desktop -f ^" + n + ":}%{A3:bspc node -d ^" + n + ":}";
+
+      if (i == 3) {
+        data += "%{F#ffffb52a}%{u#ffffb52a}%{+u}%{B#ff444444}  " + n + "  %{B-}%{-u}%{F-}";
+      } else if (i % 4 == 0) {
+        data += "%{F#ff55aa55}%{+o}  " + n + "  %{-o}%{F-}";
+      } else {
+        data += "%{F#ff888888}  " + n + "  %{F-}";
+      }
+
+      data += "%{A}%{A}%{O4}";
+    }
+
+    data += "%{A}%{A}%{B-}%{c}%{T2}\xe2\x97\x8f%{T-} polybar %{r}%{R} 12:34 %{R}";
+  }
+
+  return data;
+}
+
+/**
+ * Time compiling the same input repeatedly, returns the number
+ * of microseconds per compile
+ */
+template <typename Parser>
+double measure(Parser& p, const bar_settings& bar, const string& data, size_t iterations, drawlist& list) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    list.clear();
+    p.compile(bar, data, list);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return static_cast<double>(ns) / iterations / 1000.0;
+}
+
+int main() {
+  bar_settings bar{};
+  bar.background = 0xFF000000;
+  bar.foreground = 0xFFFFFFFF;
+
+  auto current = parser::make();
+  legacy::parser old;
+  drawlist list;
+  drawlist old_list;
+  bool same{true};
+
+  std::printf("%8s %9s %14s %14s\n", "size", "ops", "old", "current");
+
+  for (size_t repeat : {1, 4, 16, 64}) {
+    const string data{generate(repeat)};
+    const size_t iterations{20000 / repeat};
+
+    auto old_us = measure(old, bar, data, iterations, old_list);
+    auto current_us = measure(*current, bar, data, iterations, list);
+    same = same && list == old_list;
+
+    std::printf("%5.1f KB %5zu ops %8.2f us/op %8.2f us/op\n", data.size() / 1024.0, list.size(), old_us,
+        current_us);
+  }
+
+  return same ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+
+#include "events/signal.hpp"
+#include "events/signal_emitter.cpp"
+#include "utils/factory.cpp"
+
+using namespace polybar;
+using namespace signals;
+
+namespace legacy {
+  /**
+   * Frozen copy of the emitter before the dispatch tables: receivers
+   * are kept in a priority multimap per signal id, each emit casts
+   * them with dynamic_cast and signals without receivers throw from
+   * the lookup
+   */
+  class signal_emitter {
+   public:
+    template <typename Signal>
+    bool emit(const Signal& sig) {
+      try {
+        for (auto&& item : m_receivers.at(Signal::id())) {
+          if (on(item.second, sig)) {
+            return true;
+          }
+        }
+      } catch (...) {
+      }
+
+      return false;
+    }
+
+    template <uint8_t Priority, typename Signal, typename... Signals>
+    void attach(signal_receiver<Priority, Signal, Signals...>* s) {
+      for (uint8_t id : {Signal::id(), Signals::id()...}) {
+        m_receivers[id].emplace(s->priority(), s);
+      }
+    }
+
+   protected:
+    template <typename Signal>
+    static bool on(signal_receiver_interface* receiver, const Signal& sig) {
+      auto event_sink = dynamic_cast<signal_receiver_impl<Signal>*>(receiver);
+      return event_sink != nullptr && event_sink->on(sig);
+    }
+
+   private:
+    using prio_map = std::multimap<signal_receiver_interface::prio, signal_receiver_interface*>;
+    std::unordered_map<uint8_t, prio_map> m_receivers;
+  };
+}
+
+/**
+ * Receiver subscribed to a handful of signals that never
+ * stops propagation, so every emit visits all receivers
+ */
+template <uint8_t Priority>
+class receiver : public signal_receiver<Priority, ui::tick, ui::shade_window, eventqueue::check_state> {
+ public:
+  bool on(const ui::tick&) {
+    calls++;
+    return false;
+  }
+  bool on(const ui::shade_window&) {
+    return false;
+  }
+  bool on(const eventqueue::check_state&) {
+    return false;
+  }
+
+  size_t calls{0};
+};
+
+/**
+ * Time emitting the same signal repeatedly, returns
+ * the number of nanoseconds per emit
+ */
+template <typename Signal, typename Emitter>
+double measure(Emitter& emitter, size_t iterations) {
+  const Signal sig{};
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    emitter.emit(sig);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return static_cast<double>(ns) / iterations;
+}
+
+int main() {
+  const size_t iterations{1000000};
+  auto& emitter = signal_emitter::make();
+  legacy::signal_emitter old;
+
+  receiver<0> a;
+  receiver<1> b;
+  receiver<2> c;
+  receiver<3> d;
+  emitter.attach(&a);
+  emitter.attach(&b);
+  emitter.attach(&c);
+  emitter.attach(&d);
+  old.attach(&a);
+  old.attach(&b);
+  old.attach(&c);
+  old.attach(&d);
+
+  std::printf("%-20s %14s %14s\n", "", "old", "current");
+  std::printf("%-20s %8.2f ns/emit %8.2f ns/emit\n", "attached signal", measure<ui::tick>(old, iterations),
+      measure<ui::tick>(emitter, iterations));
+  std::printf("%-20s %8.2f ns/emit %8.2f ns/emit\n", "unattached signal", measure<ui::unshade_window>(old, iterations),
+      measure<ui::unshade_window>(emitter, iterations));
+
+  emitter.detach(&a);
+  emitter.detach(&b);
+  emitter.detach(&c);
+  emitter.detach(&d);
+
+  return a.calls + b.calls + c.calls + d.calls == 8 * iterations ? 0 : 1;
+}
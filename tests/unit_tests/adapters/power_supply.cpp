@@ -0,0 +1,83 @@
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+
+#include "adapters/power_supply.cpp"
+#include "utils/file.cpp"
+#include "utils/procfs.cpp"
+
+namespace {
+  void write_value(const std::string& path, const std::string& value) {
+    std::ofstream out(path, std::ios::trunc);
+    out << value << "\n";
+  }
+}
+
+int main() {
+  using namespace polybar;
+
+  char root[]{"/tmp/polybar-power-supply-XXXXXX"};
+  expect(mkdtemp(root) != nullptr);
+
+  const string battery_path{string{root} + "/BAT0"};
+  const string adapter_path{string{root} + "/ADP1"};
+  expect(mkdir(battery_path.c_str(), 0755) == 0);
+  expect(mkdir(adapter_path.c_str(), 0755) == 0);
+
+  write_value(battery_path + "/status", "Discharging");
+  write_value(battery_path + "/charge_full", "4000000");
+  write_value(battery_path + "/charge_now", "3000000");
+  write_value(battery_path + "/voltage_now", "10000000");
+  write_value(battery_path + "/current_now", "1000000");
+
+  "missing"_test = [&] {
+    bool thrown{false};
+    try {
+      power_supply::battery battery{string{root} + "/BAT1", adapter_path};
+    } catch (const power_supply::power_supply_error&) {
+      thrown = true;
+    }
+    expect(thrown);
+  };
+
+  "status"_test = [&] {
+    power_supply::battery battery{battery_path, adapter_path};
+    expect(battery.name() == "BAT0");
+    expect(battery.adapter() == "ADP1");
+
+    expect(battery.update(true));
+    expect(!battery.charging());
+    expect(battery.percentage() == 75);
+    expect(battery.seconds() == 3 * 3600);
+    expect(!battery.update(true));
+
+    write_value(battery_path + "/status", "Charging");
+    write_value(battery_path + "/charge_now", "3500000");
+    expect(battery.update(true));
+    expect(battery.charging());
+    expect(battery.percentage() == 87);
+    expect(battery.seconds() == 1800);
+  };
+
+  "adapter"_test = [&] {
+    write_value(adapter_path + "/online", "0");
+    power_supply::battery battery{battery_path, adapter_path};
+
+    expect(battery.update());
+    expect(!battery.charging());
+    expect(battery.seconds() == 0);
+
+    write_value(adapter_path + "/online", "1");
+    expect(battery.update());
+    expect(battery.charging());
+    expect(!battery.update());
+  };
+
+  for (auto&& file : {"status", "charge_full", "charge_now", "voltage_now", "current_now"}) {
+    unlink((battery_path + "/" + file).c_str());
+  }
+  unlink((adapter_path + "/online").c_str());
+  rmdir(battery_path.c_str());
+  rmdir(adapter_path.c_str());
+  rmdir(root);
+}
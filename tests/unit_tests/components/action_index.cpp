@@ -0,0 +1,58 @@
+#include "components/action_index.cpp"
+
+int main() {
+  using namespace polybar;
+
+  const auto block = [](mousebtn btn, string cmd, double start, double end, bool active = false) {
+    action_block a{};
+    a.button = btn;
+    a.command = move(cmd);
+    a.start_x = start;
+    a.end_x = end;
+    a.active = active;
+    return a;
+  };
+
+  const auto find = [](const action_index& index, mousebtn btn, int16_t x) -> string {
+    auto action = index.find(btn, x);
+    return action ? action->command : "";
+  };
+
+  "empty"_test = [&] {
+    action_index index{{}};
+    expect(index.find(mousebtn::LEFT, 10) == nullptr);
+  };
+
+  "bounds"_test = [&] {
+    action_index index{{block(mousebtn::LEFT, "a", 10, 20), block(mousebtn::LEFT, "b", 20, 30)}};
+    expect(find(index, mousebtn::LEFT, 10) == "");
+    expect(find(index, mousebtn::LEFT, 11) == "a");
+    expect(find(index, mousebtn::LEFT, 20) == "a");
+    expect(find(index, mousebtn::LEFT, 21) == "b");
+    expect(find(index, mousebtn::LEFT, 30) == "b");
+    expect(find(index, mousebtn::LEFT, 31) == "");
+    expect(find(index, mousebtn::RIGHT, 15) == "");
+  };
+
+  "nested"_test = [&] {
+    action_index index{{block(mousebtn::SCROLL_UP, "up", 0, 100), block(mousebtn::LEFT, "outer", 0, 100),
+        block(mousebtn::LEFT, "inner", 40, 60), block(mousebtn::LEFT, "open", 0, 0, true)}};
+    expect(find(index, mousebtn::SCROLL_UP, 50) == "up");
+    expect(find(index, mousebtn::LEFT, 50) == "outer");
+    expect(find(index, mousebtn::LEFT, 1) == "outer");
+  };
+
+  "first_match"_test = [&] {
+    action_index index{{block(mousebtn::LEFT, "a", 40, 60), block(mousebtn::LEFT, "b", 0, 100)}};
+    expect(find(index, mousebtn::LEFT, 30) == "b");
+    expect(find(index, mousebtn::LEFT, 50) == "a");
+    expect(find(index, mousebtn::LEFT, 70) == "b");
+  };
+
+  "gaps"_test = [&] {
+    action_index index{{block(mousebtn::LEFT, "a", 0, 10), block(mousebtn::LEFT, "b", 50, 60)}};
+    expect(find(index, mousebtn::LEFT, 30) == "");
+    expect(find(index, mousebtn::LEFT, 55) == "b");
+    expect(index.actions().size() == 2);
+  };
+}
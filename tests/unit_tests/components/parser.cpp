@@ -0,0 +1,123 @@
+#include "components/drawlist.cpp"
+#include "components/parser.cpp"
+#include "utils/factory.cpp"
+#include "utils/string.cpp"
+
+int main() {
+  using namespace polybar;
+
+  bar_settings bar{};
+  bar.background = 0xFF000000;
+  bar.foreground = 0xFFFFFFFF;
+
+  const auto compile = [&](const string& data) {
+    drawlist list;
+    parser::make()->compile(bar, data, list);
+    return list;
+  };
+
+  const auto text = [](const drawlist& list, const drawlist::op& o) {
+    string result;
+    for (size_t i = 0; i < o.length; i++) {
+      result += static_cast<char>(list.text(o)[i]);
+    }
+    return result;
+  };
+
+  "text"_test = [&] {
+    auto list = compile("foo bar");
+    expect(list.size() == 1);
+    expect(list.ops()[0].type == drawop::TEXT);
+    expect(text(list, list.ops()[0]) == "foo bar");
+  };
+
+  "unicode"_test = [&] {
+    auto list = compile("a\xc3\xa5\xe2\x82\xac");
+    expect(list.size() == 1);
+    expect(list.ops()[0].length == 3);
+    expect(list.text(list.ops()[0])[1] == 0xe5);
+    expect(list.text(list.ops()[0])[2] == 0x20ac);
+  };
+
+  "supplementary"_test = [&] {
+    auto list = compile("\xf0\x9f\x98\x80 \xf8\x88\x80\x80\x80");
+    expect(list.size() == 1);
+    expect(list.ops()[0].length == 3);
+    expect(list.text(list.ops()[0])[0] == 0x1f600);
+    expect(list.text(list.ops()[0])[2] == 0xfffd);
+  };
+
+  "long_text"_test = [&] {
+    auto list = compile("0123456789abcdef%{F-}01234567%x%{F-}");
+    expect(list.size() == 4);
+    expect(text(list, list.ops()[0]) == "0123456789abcdef");
+    expect(text(list, list.ops()[2]) == "01234567%x");
+  };
+
+  "colors"_test = [&] {
+    auto list = compile("%{F#ff0000 B-}x%{F-}");
+    expect(list.size() == 4);
+    expect(list.ops()[0].type == drawop::FOREGROUND);
+    expect(list.ops()[0].value == 0xFFFF0000);
+    expect(list.ops()[1].type == drawop::BACKGROUND);
+    expect(list.ops()[1].value == bar.background);
+    expect(list.ops()[2].type == drawop::TEXT);
+    expect(list.ops()[3].type == drawop::FOREGROUND);
+    expect(list.ops()[3].value == bar.foreground);
+  };
+
+  "tags"_test = [&] {
+    auto list = compile("%{r}%{T2}%{O-5}%{+u}%{!o}x");
+    expect(list.size() == 6);
+    expect(list.ops()[0].type == drawop::ALIGNMENT);
+    expect(static_cast<alignment>(list.ops()[0].value) == alignment::RIGHT);
+    expect(list.ops()[1].type == drawop::FONT);
+    expect(list.ops()[1].value == 2);
+    expect(list.ops()[2].type == drawop::OFFSET);
+    expect(static_cast<int16_t>(list.ops()[2].value) == -5);
+    expect(list.ops()[3].type == drawop::ATTRIBUTE_SET);
+    expect(list.ops()[4].type == drawop::ATTRIBUTE_TOGGLE);
+  };
+
+  "actions"_test = [&] {
+    auto list = compile("%{A3:cmd\\:arg:}x%{A}");
+    expect(list.size() == 3);
+    expect(list.ops()[0].type == drawop::ACTION_BEGIN);
+    expect(list.get_action(list.ops()[0]).button == mousebtn::RIGHT);
+    expect(list.get_action(list.ops()[0]).command == "cmd\\:arg");
+    expect(list.ops()[2].type == drawop::ACTION_END);
+    expect(static_cast<mousebtn>(list.ops()[2].value) == mousebtn::RIGHT);
+  };
+
+  "action_tag_list"_test = [&] {
+    auto list = compile("%{A1:a b: F#f00}x%{A}");
+    expect(list.size() == 4);
+    expect(list.get_action(list.ops()[0]).command == "a b");
+    expect(list.ops()[1].type == drawop::FOREGROUND);
+  };
+
+  "unclosed_tag"_test = [&] {
+    auto list = compile("a%{F#f00");
+    expect(list.size() == 1);
+    expect(text(list, list.ops()[0]) == "a%{F#f00");
+  };
+
+  "unclosed_action"_test = [&] {
+    bool thrown{false};
+    try {
+      compile("%{A:cmd:}x");
+    } catch (const unclosed_actionblocks&) {
+      thrown = true;
+    }
+    expect(thrown);
+  };
+
+  "append"_test = [&] {
+    auto list = compile("foo");
+    list.append(compile("bar%{A:a:}baz%{A}"));
+    expect(list.size() == 4);
+    expect(text(list, list.ops()[0]) == "foobar");
+    expect(list == compile("foobar%{A:a:}baz%{A}"));
+    expect(list != compile("foobar%{A:b:}baz%{A}"));
+  };
+}
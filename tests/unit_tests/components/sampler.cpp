@@ -0,0 +1,175 @@
+#include <cstdio>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "components/sampler.cpp"
+#include "utils/factory.cpp"
+#include "utils/procfs.cpp"
+
+int main() {
+  using namespace polybar;
+
+  struct test_sampler : public sampler {
+    using sampler::subscribe;
+  };
+
+  struct tempfile {
+    tempfile() : fd(mkstemp(path)) {}
+    ~tempfile() {
+      ::close(fd);
+      unlink(path);
+    }
+    void write(const string& contents) {
+      expect(ftruncate(fd, 0) == 0);
+      expect(pwrite(fd, contents.data(), contents.size(), 0) == static_cast<ssize_t>(contents.size()));
+    }
+    char path[32]{"/tmp/polybar-sampler-XXXXXX"};
+    int fd;
+  };
+
+  "shared"_test = [] {
+    test_sampler s;
+    tempfile zone;
+    zone.write("42000\n");
+
+    auto a = s.thermal(zone.path, 1h);
+    auto b = s.thermal(zone.path, 1h);
+    auto first = a.get();
+    expect(first && first->millidegrees == 42000);
+
+    zone.write("43000\n");
+    expect(b.get() == first);
+  };
+
+  "fastest_interval"_test = [] {
+    test_sampler s;
+    tempfile zone;
+    zone.write("42000\n");
+
+    auto slow = s.thermal(zone.path, 1h);
+    expect(slow.get()->millidegrees == 42000);
+    zone.write("43000\n");
+    expect(slow.get()->millidegrees == 42000);
+
+    auto fast = s.thermal(zone.path, 10ms);
+    std::this_thread::sleep_for(20ms);
+    expect(slow.get()->millidegrees == 43000);
+    expect(fast.get()->millidegrees == 43000);
+  };
+
+  "release"_test = [] {
+    test_sampler s;
+    tempfile zone;
+    zone.write("42000\n");
+
+    auto a = s.thermal(zone.path, 1h);
+    expect(a.get()->millidegrees == 42000);
+    zone.write("43000\n");
+
+    a = s.thermal(zone.path, 1h);
+    expect(a.get()->millidegrees == 42000);
+
+    a = {};
+    expect(!a && !a.get());
+    a = s.thermal(zone.path, 1h);
+    expect(a.get()->millidegrees == 43000);
+  };
+
+  "missing"_test = [] {
+    test_sampler s;
+    auto a = s.thermal("/nonexistent/polybar", 1h);
+    expect(a && !a.get());
+  };
+
+  "cpu"_test = [] {
+    test_sampler s;
+    tempfile stat;
+    stat.write("cpu  20 0 20 160\ncpu0 10 0 10 80\ncpu1 10 0 10 80\nintr 1\n");
+
+    auto sub = s.subscribe<cpu_sample>(stat.path, 0s);
+    auto first = sub.get();
+    expect(first->cores == 2);
+    expect(first->times[CPU_USER][1] == 10 && first->times[CPU_STEAL][1] == 0);
+    expect(first->total[1] == 100 && first->idle[1] == 80);
+
+    cpu_load initial{nullptr, *first};
+    expect(initial.cores.size() == 2);
+    expect(initial.cores[0] == 0.0f && initial.average == 0.0f);
+
+    stat.write("cpu  80 0 20 200\ncpu0 60 0 10 80\ncpu1 20 0 10 120\nintr 1\n");
+    auto second = sub.get();
+    cpu_load load{first.get(), *second};
+    expect(load.cores[0] == 100.0f);
+    expect(load.cores[1] == 20.0f);
+    expect(load.average == 60.0f);
+  };
+
+  "cpu_iowait_steal"_test = [] {
+    test_sampler s;
+    tempfile stat;
+    stat.write("cpu  0 0 0 0\ncpu0 10 0 10 60 20 0 0 0 5 0\n");
+
+    auto sub = s.subscribe<cpu_sample>(stat.path, 0s);
+    auto first = sub.get();
+    expect(first->total[0] == 100 && first->idle[0] == 80);
+
+    stat.write("cpu  0 0 0 0\ncpu0 20 0 10 60 30 0 0 10 5 0\n");
+    auto second = sub.get();
+    expect(second->times[CPU_IOWAIT][0] == 30);
+    expect(second->times[CPU_STEAL][0] == 10);
+    cpu_load load{first.get(), *second};
+    expect(load.cores[0] > 66.6f && load.cores[0] < 66.7f);
+  };
+
+  "cpu_consumers"_test = [] {
+    test_sampler s;
+    tempfile stat;
+    stat.write("cpu  0 0 0 0\ncpu0 10 0 10 80\n");
+
+    // each consumer compares against the last sample it used
+    auto fast = s.subscribe<cpu_sample>(stat.path, 0s);
+    auto slow = s.subscribe<cpu_sample>(stat.path, 1h);
+    auto fast_prev = fast.get();
+    auto slow_prev = slow.get();
+
+    stat.write("cpu  0 0 0 0\ncpu0 60 0 10 80\n");
+    auto fast_next = fast.get();
+    expect(cpu_load(fast_prev.get(), *fast_next).cores[0] == 100.0f);
+    fast_prev = fast_next;
+
+    stat.write("cpu  0 0 0 0\ncpu0 60 0 10 130\n");
+    fast_next = fast.get();
+    auto slow_next = slow.get();
+    expect(cpu_load(fast_prev.get(), *fast_next).cores[0] == 0.0f);
+    expect(cpu_load(slow_prev.get(), *slow_next).cores[0] == 50.0f);
+    expect(cpu_load(slow_prev.get(), *slow_next).average == 50.0f);
+  };
+
+  "memory"_test = [] {
+    test_sampler s;
+    tempfile meminfo;
+    meminfo.write("MemTotal:       16000 kB\nMemFree:  1 kB\nMemAvailable:   4000 kB\n");
+
+    auto sample = s.subscribe<memory_sample>(meminfo.path, 1s).get();
+    expect(sample->kb_total == 16000);
+    expect(sample->kb_avail == 4000);
+  };
+
+  "net"_test = [] {
+    test_sampler s;
+    tempfile netdev;
+    netdev.write(
+        "Inter-|   Receive                            |  Transmit\n"
+        " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets\n"
+        "    lo:    100       1    0    0    0     0          0         0      200       2\n"
+        "  eth0:1000 10 0 0 0 0 0 0 2000 20 0 0 0 0 0 0\n");
+
+    auto sample = s.subscribe<net_sample>(netdev.path, 1s).get();
+    expect(sample->devices.size() == 2);
+    expect(sample->devices[0].name == "lo");
+    expect(sample->devices[0].received == 100 && sample->devices[0].transmitted == 200);
+    expect(sample->devices[1].name == "eth0");
+    expect(sample->devices[1].received == 1000 && sample->devices[1].transmitted == 2000);
+  };
+}
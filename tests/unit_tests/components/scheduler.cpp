@@ -0,0 +1,87 @@
+#include <atomic>
+#include <future>
+
+#include "components/logger.cpp"
+#include "components/scheduler.cpp"
+#include "events/signal_emitter.cpp"
+#include "utils/concurrency.cpp"
+#include "utils/factory.cpp"
+#include "utils/string.cpp"
+#include "utils/timer_wheel.cpp"
+
+int main() {
+  using namespace polybar;
+
+  signal_emitter emitter;
+  logger log{loglevel::NONE};
+
+  "blocking"_test = [&] {
+    scheduler sched{emitter, log};
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic_int fast{0};
+
+    auto slow_task = sched.add(10ms, [&] {
+      released.wait();
+      return false;
+    });
+    auto fast_task = sched.add(10ms, [&] {
+      fast++;
+      return false;
+    });
+
+    // the fast task keeps running while a worker is blocked
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (fast < 5 && chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(10ms);
+    }
+    expect(fast >= 5);
+
+    release.set_value();
+    sched.remove(slow_task);
+    sched.remove(fast_task);
+  };
+
+  "exclusive"_test = [&] {
+    scheduler sched{emitter, log};
+    std::atomic_int running{0};
+    std::atomic_int overlaps{0};
+    std::atomic_int runs{0};
+
+    auto task = sched.add(10ms, [&] {
+      overlaps += running++ > 0 ? 1 : 0;
+      std::this_thread::sleep_for(30ms);
+      running--;
+      runs++;
+      return false;
+    });
+
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (runs < 5 && chrono::steady_clock::now() < deadline) {
+      sched.trigger(task);
+      std::this_thread::sleep_for(5ms);
+    }
+    sched.remove(task);
+
+    expect(runs >= 5);
+    expect(overlaps == 0);
+    expect(running == 0);
+  };
+
+  "remove"_test = [&] {
+    scheduler sched{emitter, log};
+    std::promise<void> started;
+    std::atomic_bool done{false};
+
+    auto task = sched.add(10s, [&] {
+      started.set_value();
+      std::this_thread::sleep_for(50ms);
+      done = true;
+      return false;
+    });
+
+    expect(started.get_future().wait_for(5s) == std::future_status::ready);
+    sched.remove(task);
+    expect(done);
+  };
+}
@@ -0,0 +1,114 @@
+#include <atomic>
+#include <condition_variable>
+
+#include "components/taskqueue.cpp"
+
+namespace {
+  /**
+   * Counts the signals sent by the deferred callbacks
+   */
+  class latch {
+   public:
+    void notify() {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_count++;
+      m_cond.notify_all();
+    }
+
+    bool wait(size_t count) {
+      std::unique_lock<std::mutex> guard(m_lock);
+      return m_cond.wait_for(guard, std::chrono::seconds{5}, [&] { return m_count >= count; });
+    }
+
+   private:
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    size_t m_count{0};
+  };
+}
+
+int main() {
+  using namespace polybar;
+
+  "defer"_test = [] {
+    auto queue = taskqueue::make();
+    std::atomic<size_t> calls{0};
+    latch done;
+    queue->defer("task", 10ms, [&](size_t remaining) {
+      expect(remaining == 0);
+      calls++;
+      done.notify();
+    });
+    expect(queue->exist("task"));
+    expect(done.wait(1));
+    expect(calls == 1);
+    expect(!queue->exist("task"));
+  };
+
+  "count"_test = [] {
+    auto queue = taskqueue::make();
+    std::atomic<size_t> calls{0};
+    std::atomic<size_t> last{99};
+    latch done;
+    queue->defer("task", 5ms, [&](size_t remaining) {
+      calls++;
+      last = remaining;
+      done.notify();
+    }, 0ms, 3);
+    expect(done.wait(3));
+    expect(calls == 3);
+    expect(last == 0);
+    expect(!queue->exist("task"));
+  };
+
+  "ordering"_test = [] {
+    auto queue = taskqueue::make();
+    std::mutex lock;
+    string order;
+    latch done;
+    auto append = [&](char c) {
+      return [&, c](size_t) {
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          order += c;
+        }
+        done.notify();
+      };
+    };
+    queue->defer("c", 60ms, append('c'));
+    queue->defer("a", 20ms, append('a'));
+    queue->defer("b", 40ms, append('b'));
+    expect(done.wait(3));
+    std::lock_guard<std::mutex> guard(lock);
+    expect(order == "abc");
+  };
+
+  "purge"_test = [] {
+    auto queue = taskqueue::make();
+    std::atomic<size_t> calls{0};
+    latch done;
+    queue->defer("a", 30ms, [&](size_t) { calls++; });
+    queue->defer("a", 40ms, [&](size_t) { calls++; });
+    queue->defer("b", 50ms, [&](size_t) {
+      calls += 10;
+      done.notify();
+    });
+    expect(queue->purge("a"));
+    expect(!queue->purge("a"));
+    expect(!queue->exist("a"));
+    expect(queue->exist("b"));
+    expect(done.wait(1));
+    expect(calls == 10);
+  };
+
+  "defer_unique"_test = [] {
+    auto queue = taskqueue::make();
+    std::atomic<size_t> calls{0};
+    latch done;
+    queue->defer_unique("task", 30ms, [&](size_t) { calls++; });
+    queue->defer_unique("task", 30ms, [&](size_t) { calls += 10; });
+    queue->defer("end", 50ms, [&](size_t) { done.notify(); });
+    expect(done.wait(1));
+    expect(calls == 10);
+  };
+}
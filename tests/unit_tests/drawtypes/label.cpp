@@ -0,0 +1,95 @@
+#include <type_traits>
+
+#include "components/config.cpp"
+#include "components/logger.cpp"
+#include "drawtypes/label.cpp"
+#include "utils/concurrency.cpp"
+#include "utils/env.cpp"
+#include "utils/factory.cpp"
+#include "utils/file.cpp"
+#include "utils/string.cpp"
+#include "x11/color.cpp"
+#include "x11/xlib.cpp"
+#include "x11/xresources.cpp"
+
+int main() {
+  using namespace polybar;
+  using namespace drawtypes;
+
+  static_assert(!std::is_copy_constructible<label>::value, "labels must not be copied");
+  static_assert(!std::is_copy_assignable<label>::value, "labels must not be copied");
+
+  const auto make = [](string text) {
+    auto tokens = tokenize(text);
+    return factory_util::shared<label>(text, ""s, ""s, ""s, ""s, 0, side_values{0U, 0U}, side_values{0U, 0U}, 0_z,
+        true, move(tokens));
+  };
+
+  "tokenize"_test = [] {
+    string text{"%{F#f00}%name:2:4:..% %{F-}%total%"};
+    auto tokens = tokenize(text);
+    expect(text == "%{F#f00}%name% %{F-}%total%");
+    expect(tokens.size() == 2);
+    expect(tokens[0].token == "%name%");
+    expect(tokens[0].min == 2);
+    expect(tokens[0].max == 4);
+    expect(tokens[0].suffix == "..");
+    expect(tokens[1].token == "%total%");
+    expect(tokens[1].min == 0 && tokens[1].max == 0);
+  };
+
+  "replace"_test = [&] {
+    auto l = make("%{F#f00}%a% and %b:3% %{F-}");
+    expect(l->get() == "%{F#f00}%a% and %b% %{F-}");
+    expect(l->has_token("%a%"));
+    expect(!l->has_token("%{F#f00}"));
+
+    l->replace_token("%a%", "x");
+    l->replace_token("%b%", "y");
+    expect(l->get() == "%{F#f00}x and   y %{F-}");
+
+    l->replace_token(l->slot("%a%"), "z");
+    expect(l->get() == "%{F#f00}z and   y %{F-}");
+    l->replace_token("%missing%", "w");
+    expect(l->get() == "%{F#f00}z and   y %{F-}");
+  };
+
+  "repeated"_test = [&] {
+    // the rules of the first definition apply to all occurrences
+    auto l = make("%a:0:2:~% %a:5% %a%");
+    expect(l->get() == "%a% %a% %a%");
+    l->replace_token("%a%", "abcd");
+    expect(l->get() == "ab~ ab~ ab~");
+    l->replace_token("%a%", "a");
+    expect(l->get() == "a a a");
+  };
+
+  "reset"_test = [&] {
+    auto l = make("%a% %b%");
+    l->replace_token("%a%", "1");
+    l->replace_token("%b%", "2");
+    expect(l->get() == "1 2");
+    l->reset_tokens();
+    expect(l->get() == "%a% %b%");
+    l->replace_token("%b%", "3");
+    expect(l->get() == "%a% 3");
+  };
+
+  "clone"_test = [&] {
+    auto l = make("<%a:3%>");
+    l->replace_token("%a%", "x");
+    auto copy = l->clone();
+    l.reset();
+
+    expect(copy->get() == "<%a%>");
+    expect(copy->has_token("%a%"));
+    copy->replace_token("%a%", "y");
+    expect(copy->get() == "<  y>");
+  };
+
+  "plain"_test = [&] {
+    auto l = make("100% %{T2}");
+    expect(l->get() == "100% %{T2}");
+    expect(!l->has_token("%{T2}"));
+  };
+}
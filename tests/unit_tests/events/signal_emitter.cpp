@@ -0,0 +1,90 @@
+#include "events/signal.hpp"
+#include "events/signal_emitter.cpp"
+#include "utils/factory.cpp"
+
+using namespace polybar;
+using namespace signals;
+
+string g_order;
+
+template <uint8_t Priority>
+class receiver : public signal_receiver<Priority, ui::tick, eventqueue::update> {
+ public:
+  explicit receiver(char name, bool stop = false) : m_name(name), m_stop(stop) {}
+
+  bool on(const ui::tick&) {
+    g_order += m_name;
+    return m_stop;
+  }
+
+  bool on(const eventqueue::update& evt) {
+    g_order += *evt() ? static_cast<char>(m_name - 32) : m_name;
+    return false;
+  }
+
+ private:
+  char m_name;
+  bool m_stop;
+};
+
+int main() {
+  auto& emitter = signal_emitter::make();
+
+  "priority"_test = [&] {
+    receiver<2> c{'c'};
+    receiver<0> a{'a'};
+    receiver<1> b{'b'};
+    emitter.attach(&c);
+    emitter.attach(&a);
+    emitter.attach(&b);
+    g_order.clear();
+    expect(!emitter.emit(ui::tick{}));
+    expect(g_order == "abc");
+    g_order.clear();
+    expect(!emitter.emit(eventqueue::update{true}));
+    expect(g_order == "ABC");
+    emitter.detach(&a);
+    emitter.detach(&b);
+    emitter.detach(&c);
+  };
+
+  "same_priority"_test = [&] {
+    receiver<1> a{'a'};
+    receiver<1> b{'b'};
+    emitter.attach(&a);
+    emitter.attach(&b);
+    g_order.clear();
+    emitter.emit(ui::tick{});
+    expect(g_order == "ab");
+    emitter.detach(&a);
+    emitter.detach(&b);
+  };
+
+  "stop_propagation"_test = [&] {
+    receiver<0> a{'a', true};
+    receiver<1> b{'b'};
+    emitter.attach(&a);
+    emitter.attach(&b);
+    g_order.clear();
+    expect(emitter.emit(ui::tick{}));
+    expect(g_order == "a");
+    emitter.detach(&a);
+    emitter.detach(&b);
+  };
+
+  "detach"_test = [&] {
+    receiver<0> a{'a'};
+    receiver<1> b{'b'};
+    emitter.attach(&a);
+    emitter.attach(&b);
+    emitter.detach(&a);
+    g_order.clear();
+    emitter.emit(ui::tick{});
+    expect(g_order == "b");
+    emitter.detach(&b);
+    g_order.clear();
+    expect(!emitter.emit(ui::tick{}));
+    expect(!emitter.emit(ui::shade_window{}));
+    expect(g_order.empty());
+  };
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "utils/inotify.cpp"
+
+int main() {
+  using namespace polybar;
+
+  "events"_test = [] {
+    char path[]{"/tmp/polybar-inotify-XXXXXX"};
+    int fd{mkstemp(path)};
+    expect(fd != -1);
+
+    inotify_watcher watcher;
+    int wd{watcher.attach(path, IN_MODIFY)};
+    expect(wd != -1);
+    expect(!watcher.poll(0));
+
+    expect(write(fd, "a", 1) == 1);
+    expect(write(fd, "b", 1) == 1);
+    expect(watcher.poll(100));
+
+    size_t modified{0};
+    auto count = watcher.read([&](const polybar::inotify_event& e) {
+      expect(e.wd == wd);
+      expect(e.filename == path);
+      modified += (e.mask & IN_MODIFY) ? 1 : 0;
+    });
+    expect(count == modified);
+    expect(modified >= 1);
+    expect(!watcher.poll(0));
+    expect(watcher.read(nullptr) == 0);
+
+    ::close(fd);
+    unlink(path);
+    expect(watcher.poll(100));
+
+    bool ignored{false};
+    watcher.read([&](const polybar::inotify_event& e) { ignored |= (e.mask & IN_IGNORED) != 0; });
+    expect(ignored);
+  };
+
+  "interrupt"_test = [] {
+    inotify_watcher watcher;
+    auto start = std::chrono::steady_clock::now();
+    std::thread waker([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds{20});
+      watcher.interrupt();
+    });
+    expect(!watcher.poll(5000));
+    waker.join();
+    expect(std::chrono::steady_clock::now() - start < std::chrono::seconds{1});
+    expect(!watcher.poll(0));
+  };
+
+  "missing"_test = [] {
+    inotify_watcher watcher;
+    bool thrown{false};
+    try {
+      watcher.attach("/nonexistent/polybar");
+    } catch (const system_error&) {
+      thrown = true;
+    }
+    expect(thrown);
+  };
+}
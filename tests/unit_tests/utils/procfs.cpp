@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <cstring>
+
+#include "utils/procfs.cpp"
+
+int main() {
+  using namespace polybar;
+
+  "scanner"_test = [] {
+    const char* stat{"cpu  10 20 30 40\ncpu0 1 2 3 4 5\ncpu1 6 7\nintr 99\n"};
+    procfs_scanner scanner{stat, strlen(stat)};
+    long long value{0};
+
+    expect(scanner.match("cpu"));
+    expect(scanner.match("cpu "));
+    scanner.next_line();
+    expect(scanner.match("cpu0"));
+    scanner.skip_word();
+    expect(scanner.next(value) && value == 1);
+    expect(scanner.next(value) && value == 2);
+    scanner.next_line();
+    scanner.skip_word();
+    expect(scanner.next(value) && value == 6);
+    expect(scanner.next(value) && value == 7);
+    expect(!scanner.next(value));
+    scanner.next_line();
+    expect(!scanner.match("cpu"));
+    scanner.next_line();
+    expect(scanner.eof());
+  };
+
+  "seek"_test = [] {
+    const char* meminfo{"MemTotal:       16314888 kB\nMemFree:  1 kB\nMemAvailable:   -42 kB\n"};
+    procfs_scanner scanner{meminfo, strlen(meminfo)};
+    long long value{0};
+
+    expect(scanner.seek("MemAvailable:"));
+    expect(scanner.next(value) && value == -42);
+    expect(!scanner.seek("MemTotal:"));
+
+    scanner = procfs_scanner{meminfo, strlen(meminfo)};
+    expect(scanner.seek("MemTotal:"));
+    expect(scanner.next(value) && value == 16314888);
+  };
+
+  "word"_test = [] {
+    const char* netdev{"  eth0: 1 2\nwlan0:3 4\nbroken 5\n"};
+    procfs_scanner scanner{netdev, strlen(netdev)};
+    long long value{0};
+    string name;
+
+    expect(scanner.next(name, ':') && name == "eth0");
+    expect(scanner.next(value) && value == 1);
+    scanner.next_line();
+    expect(scanner.next(name, ':') && name == "wlan0");
+    expect(scanner.next(value) && value == 3);
+    scanner.next_line();
+    expect(!scanner.next(name, ':'));
+    expect(name == "wlan0");
+  };
+
+  "file"_test = [] {
+    char path[]{"/tmp/polybar-procfs-XXXXXX"};
+    int fd{mkstemp(path)};
+    expect(fd != -1);
+    expect(write(fd, "42000\n", 6) == 6);
+
+    procfs_file file{path};
+    long long value{0};
+    expect(file.read(value) && value == 42000);
+
+    string large(3 * BUFSIZ, 'x');
+    expect(pwrite(fd, large.data(), large.size(), 0) == static_cast<ssize_t>(large.size()));
+    expect(file.read());
+    expect(file.size() == large.size());
+    expect(!file.scan().next(value));
+
+    expect(ftruncate(fd, 0) == 0);
+    expect(pwrite(fd, "Charging\n", 9, 0) == 9);
+    expect(file.read() && file.scan().match("Charging"));
+
+    ::close(fd);
+    unlink(path);
+  };
+
+  "missing"_test = [] {
+    procfs_file file{"/nonexistent/polybar"};
+    long long value{0};
+    expect(!file.read());
+    expect(!file.read(value));
+    expect(file.size() == 0);
+  };
+}
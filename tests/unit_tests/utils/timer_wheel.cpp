@@ -0,0 +1,91 @@
+#include "utils/timer_wheel.cpp"
+
+int main() {
+  using namespace polybar;
+
+  "expire"_test = [] {
+    timer_wheel wheel;
+    vector<size_t> expired;
+    wheel.insert(1, 5);
+    wheel.insert(2, 3);
+    wheel.insert(3, 5);
+    expect(wheel.size() == 3);
+    expect(wheel.next_expiry() == 3);
+    wheel.advance(4, expired);
+    expect(expired.size() == 1);
+    expect(expired[0] == 2);
+    expect(wheel.now() == 4);
+    wheel.advance(5, expired);
+    expect(expired.size() == 3);
+    expect(expired[1] == 1);
+    expect(expired[2] == 3);
+    expect(wheel.empty());
+  };
+
+  "remove"_test = [] {
+    timer_wheel wheel;
+    vector<size_t> expired;
+    wheel.insert(1, 10);
+    wheel.insert(2, 10);
+    expect(wheel.remove(1));
+    expect(!wheel.remove(1));
+    expect(!wheel.contains(1));
+    expect(wheel.contains(2));
+    wheel.advance(20, expired);
+    expect(expired.size() == 1);
+    expect(expired[0] == 2);
+  };
+
+  "reschedule"_test = [] {
+    timer_wheel wheel;
+    vector<size_t> expired;
+    wheel.insert(1, 10);
+    wheel.insert(1, 30);
+    expect(wheel.size() == 1);
+    wheel.advance(20, expired);
+    expect(expired.empty());
+    wheel.advance(30, expired);
+    expect(expired.size() == 1);
+  };
+
+  "overdue"_test = [] {
+    timer_wheel wheel{100};
+    vector<size_t> expired;
+    wheel.insert(1, 50);
+    expect(wheel.next_expiry() == 101);
+    wheel.advance(101, expired);
+    expect(expired.size() == 1);
+  };
+
+  "cascade"_test = [] {
+    timer_wheel wheel{7};
+    vector<size_t> expired;
+    vector<timer_wheel::tick_t> deadlines{64, 65, 100, 4095, 4096, 4100, 300000, 5000000, 20000000};
+
+    for (size_t i = 0; i < deadlines.size(); i++) {
+      wheel.insert(i, deadlines[i]);
+    }
+
+    for (size_t i = 0; i < deadlines.size(); i++) {
+      expect(wheel.next_expiry() <= deadlines[i]);
+      wheel.advance(deadlines[i] - 1, expired);
+      expect(expired.size() == i);
+      wheel.advance(deadlines[i], expired);
+      expect(expired.size() == i + 1);
+      expect(expired[i] == i);
+    }
+
+    expect(wheel.empty());
+  };
+
+  "beyond range"_test = [] {
+    timer_wheel wheel{3};
+    vector<size_t> expired;
+    timer_wheel::tick_t deadline{(timer_wheel::tick_t{1} << 26) + 17};
+    wheel.insert(1, deadline);
+    wheel.advance(deadline - 1, expired);
+    expect(expired.empty());
+    wheel.advance(deadline, expired);
+    expect(expired.size() == 1);
+  };
+}
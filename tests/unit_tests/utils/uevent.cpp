@@ -0,0 +1,67 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "utils/uevent.cpp"
+
+namespace {
+  const char change[]{
+      "change@/devices/LNXSYSTM:00/PNP0C0A:00/power_supply/BAT0\0ACTION=change\0"
+      "DEVPATH=/devices/LNXSYSTM:00/PNP0C0A:00/power_supply/BAT0\0SUBSYSTEM=power_supply\0"
+      "POWER_SUPPLY_NAME=BAT0\0POWER_SUPPLY_STATUS=Charging"};
+  const char other[]{"add@/devices/virtual/net/tun0\0ACTION=add\0DEVPATH=/devices/virtual/net/tun0\0SUBSYSTEM=net"};
+  const char libudev[]{"libudev\0\xfe\xed\xca\xfe"};
+}
+
+int main() {
+  using namespace polybar;
+
+  "parse"_test = [] {
+    uevent event;
+    expect(uevent_util::parse(change, sizeof(change) - 1, event));
+    expect(event.action == "change");
+    expect(event.subsystem == "power_supply");
+    expect(event.name() == "BAT0");
+    expect(event.properties.size() == 2);
+    expect(event.properties["POWER_SUPPLY_STATUS"] == "Charging");
+  };
+
+  "reject"_test = [] {
+    uevent event;
+    expect(!uevent_util::parse(libudev, sizeof(libudev) - 1, event));
+    expect(!uevent_util::parse("ACTION=change", 13, event));
+    expect(!uevent_util::parse("change@/devices", 15, event));
+  };
+
+  "socket"_test = [] {
+    int fds[2];
+    expect(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) == 0);
+
+    uevent_socket socket{"power_supply", fds[0]};
+    expect(socket.get_file_descriptor() == fds[0]);
+    expect(!socket.poll(0));
+    expect(socket.read(nullptr) == 0);
+
+    expect(send(fds[1], other, sizeof(other) - 1, 0) > 0);
+    expect(send(fds[1], change, sizeof(change) - 1, 0) > 0);
+    expect(send(fds[1], libudev, sizeof(libudev) - 1, 0) > 0);
+    expect(send(fds[1], change, sizeof(change) - 1, 0) > 0);
+    expect(socket.poll(100));
+
+    vector<string> names;
+    expect(socket.read([&](const uevent& e) { names.emplace_back(e.name()); }) == 2);
+    expect(names == vector<string>{"BAT0", "BAT0"});
+    expect(!socket.poll(0));
+
+    close(fds[1]);
+  };
+
+  "invalid"_test = [] {
+    bool thrown{false};
+    try {
+      uevent_socket socket{"power_supply", -1};
+    } catch (const system_error&) {
+      thrown = true;
+    }
+    expect(thrown);
+  };
+}